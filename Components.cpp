@@ -0,0 +1,238 @@
+#include "Graph.h"
+
+namespace {
+
+// 分量数超过这个规模时不建立传递闭包（C * C 位），可达性查询退回在图上搜索
+const uint64_t kMaxReachBytes = 64ull << 20;
+
+const uint32_t kUnvisited = UINT32_MAX;
+
+} // namespace
+
+// 迭代版 Tarjan：用显式栈保存 (节点, 下一条出边) 代替递归，长链也不会栈溢出。
+// 分量按完成顺序编号，先完成的是汇点一侧的分量，因此每条边都从编号大的分量指向编号不大于它的分量。
+// 随后按编号从小到大求每个分量的可达分量集合：后继分量的集合都已求出，按位或即可
+void Graph::rebuildComponents() {
+    const size_t numNodes = wordCount();
+    std::vector<uint32_t> component(numNodes, kUnvisited);
+    std::vector<uint32_t> index(numNodes, kUnvisited);
+    std::vector<uint32_t> lowlink(numNodes, 0);
+    std::vector<WordId> stack;
+    std::vector<std::pair<WordId, uint64_t>> callStack;
+    std::vector<uint32_t> sizes;
+    uint32_t nextIndex = 0;
+
+    for (size_t root = 0; root < numNodes; ++root) {
+        if (index[root] != kUnvisited) continue;
+        callStack.emplace_back(static_cast<WordId>(root), outOffsets[root]);
+        index[root] = lowlink[root] = nextIndex++;
+        stack.push_back(static_cast<WordId>(root));
+
+        while (!callStack.empty()) {
+            auto& [v, edge] = callStack.back();
+            if (edge < outOffsets[v + 1]) {
+                WordId w = outTargets[edge++];
+                if (index[w] == kUnvisited) {
+                    index[w] = lowlink[w] = nextIndex++;
+                    stack.push_back(w);
+                    callStack.emplace_back(w, outOffsets[w]);
+                } else if (component[w] == kUnvisited) {
+                    // w 仍在栈上（尚未归入分量）
+                    lowlink[v] = std::min(lowlink[v], index[w]);
+                }
+                continue;
+            }
+
+            WordId finished = v;
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                WordId parent = callStack.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[finished]);
+            }
+            if (lowlink[finished] == index[finished]) {
+                uint32_t id = static_cast<uint32_t>(sizes.size());
+                uint32_t size = 0;
+                WordId member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    component[member] = id;
+                    ++size;
+                } while (member != finished);
+                sizes.push_back(size);
+            }
+        }
+    }
+
+    // 凝聚图：按分量分组节点，每个分量的后继分量用 seen 去重，得到按分量编号排列的 DAG
+    const size_t count = sizes.size();
+    std::vector<uint32_t> start(count + 1, 0);
+    for (size_t v = 0; v < numNodes; ++v) {
+        ++start[component[v] + 1];
+    }
+    for (size_t c = 0; c < count; ++c) {
+        start[c + 1] += start[c];
+    }
+    std::vector<WordId> members(numNodes);
+    std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+    for (size_t v = 0; v < numNodes; ++v) {
+        members[cursor[component[v]]++] = static_cast<WordId>(v);
+    }
+    std::vector<uint64_t> dagOffsets(count + 1, 0);
+    std::vector<uint32_t> dagTargets;
+    std::vector<uint32_t> seen(count, kUnvisited);
+    for (uint32_t c = 0; c < count; ++c) {
+        for (uint32_t i = start[c]; i < start[c + 1]; ++i) {
+            WordId v = members[i];
+            for (uint64_t e = outOffsets[v]; e < outOffsets[v + 1]; ++e) {
+                uint32_t d = component[outTargets[e]];
+                if (d == c || seen[d] == c) continue;
+                seen[d] = c;
+                dagTargets.push_back(d);
+            }
+        }
+        dagOffsets[c + 1] = dagTargets.size();
+    }
+
+    const size_t rowWords = (count + 63) / 64;
+    std::vector<uint64_t> reach;
+    if (count > 0 && count * rowWords * sizeof(uint64_t) <= kMaxReachBytes) {
+        reach.assign(count * rowWords, 0);
+        for (uint32_t c = 0; c < count; ++c) {
+            uint64_t* row = reach.data() + c * rowWords;
+            row[c / 64] |= uint64_t(1) << (c % 64);
+            for (uint64_t e = dagOffsets[c]; e < dagOffsets[c + 1]; ++e) {
+                uint32_t d = dagTargets[e];
+                const uint64_t* successor = reach.data() + d * rowWords;
+                // d < c，d 的可达集合只可能含编号不超过 d 的分量
+                for (size_t k = 0; k <= d / 64; ++k) {
+                    row[k] |= successor[k];
+                }
+            }
+        }
+    }
+
+    componentOfWord = std::move(component);
+    componentSizes = std::move(sizes);
+    componentReach = std::move(reach);
+    componentEdgeOffsets = std::move(dagOffsets);
+    componentEdges = std::move(dagTargets);
+    rebuildComponentLabels();
+}
+
+// 在凝聚图上做两次 DFS（根和后继的访问顺序相反），每次给分量 c 记下后序编号 post 和
+// low = 从 c 可达的所有分量中最小的后序编号。c 能到达 d 时 d 的区间 [low, post] 一定包含在 c 的区间里，
+// 所以任一次遍历的区间不包含即可断定不可达（GRAIL）。第一次遍历还记下 DFS 树上子树的最小后序编号：
+// 子树的后序编号连续，d 落在 c 的子树区间内即可断定可达。两种判定都不成立时才需要搜索
+void Graph::rebuildComponentLabels() {
+    const size_t count = componentSizes.size();
+    std::vector<uint32_t> labels(count * kLabelWords);
+    std::vector<uint32_t> low(count);
+    std::vector<uint32_t> first(count);
+    std::vector<char> visited;
+    std::vector<std::pair<uint32_t, uint64_t>> callStack;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        visited.assign(count, 0);
+        uint32_t nextPost = 0;
+        for (size_t r = 0; r < count; ++r) {
+            uint32_t root = static_cast<uint32_t>(pass == 0 ? count - 1 - r : r);
+            if (visited[root]) continue;
+            visited[root] = 1;
+            first[root] = nextPost;
+            low[root] = kUnvisited;
+            callStack.emplace_back(root, 0);
+
+            while (!callStack.empty()) {
+                auto& [c, i] = callStack.back();
+                uint64_t begin = componentEdgeOffsets[c];
+                uint64_t end = componentEdgeOffsets[c + 1];
+                if (i < end - begin) {
+                    uint32_t d = componentEdges[pass == 0 ? begin + i : end - 1 - i];
+                    ++i;
+                    if (!visited[d]) {
+                        visited[d] = 1;
+                        first[d] = nextPost;
+                        low[d] = kUnvisited;
+                        callStack.emplace_back(d, 0);
+                    } else {
+                        // DAG 中已访问的后继一定已经完成，它的 low 不会再变
+                        low[c] = std::min(low[c], low[d]);
+                    }
+                    continue;
+                }
+
+                uint32_t finished = c;
+                callStack.pop_back();
+                uint32_t post = nextPost++;
+                low[finished] = std::min(low[finished], post);
+                uint32_t* label = labels.data() + finished * kLabelWords;
+                if (pass == 0) {
+                    label[0] = post;
+                    label[1] = low[finished];
+                    label[2] = first[finished];
+                } else {
+                    label[3] = post;
+                    label[4] = low[finished];
+                }
+                if (!callStack.empty()) {
+                    uint32_t parent = callStack.back().first;
+                    low[parent] = std::min(low[parent], low[finished]);
+                }
+            }
+        }
+    }
+    componentLabels = std::move(labels);
+}
+
+uint32_t Graph::componentOf(const std::string& word) const {
+    WordId id = findWord(word);
+    return id == kNoWord ? kNoWord : componentOfWord[id];
+}
+
+size_t Graph::componentSize(uint32_t component) const {
+    return component < componentSizes.size() ? componentSizes[component] : 0;
+}
+
+bool Graph::canReach(const std::string& word1, const std::string& word2) const {
+    WordId from = findWord(word1);
+    WordId to = findWord(word2);
+    if (from == kNoWord || to == kNoWord) {
+        return false;
+    }
+    return componentReaches(componentOfWord[from], componentOfWord[to]);
+}
+
+// 有闭包时 O(1)；没有时先用分量编号和标签判定，判定不了再在凝聚图上搜索：
+// 只进入编号不小于 to 且标签仍可能到达 to 的分量，遇到 DFS 子树包含 to 的分量即可返回。
+// 访问标记按轮次区分，每个线程复用同一块缓冲区，不必每次按分量数清零
+bool Graph::componentReaches(uint32_t from, uint32_t to) const {
+    if (from == to) return true;
+    if (!mayReach(from, to)) return false;
+    if (!componentReach.empty() || treeReaches(from, to)) return true;
+
+    thread_local std::vector<uint32_t> stamp;
+    thread_local std::vector<uint32_t> pending;
+    thread_local uint32_t epoch = 0;
+    if (stamp.size() < componentSizes.size()) {
+        stamp.resize(componentSizes.size(), 0);
+    }
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    pending.assign(1, from);
+    stamp[from] = epoch;
+    while (!pending.empty()) {
+        uint32_t c = pending.back();
+        pending.pop_back();
+        for (uint64_t e = componentEdgeOffsets[c]; e < componentEdgeOffsets[c + 1]; ++e) {
+            uint32_t d = componentEdges[e];
+            if (stamp[d] == epoch || !mayReach(d, to)) continue;
+            if (treeReaches(d, to)) return true;
+            stamp[d] = epoch;
+            pending.push_back(d);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef FROZEN_ARRAY_H
+#define FROZEN_ARRAY_H
+
+#include <cstddef>
+#include <vector>
+
+// 冻结后的只读数组：数据要么由自身的 vector 持有，要么直接指向快照映射中的一段内存。
+// 赋值新的 vector 即可替换内容；attach 不复制数据，调用方负责保证映射的生命周期。
+template <typename T>
+class FrozenArray {
+public:
+    FrozenArray() = default;
+
+    FrozenArray(const FrozenArray& other) : owned(other.owned), ptr(other.ptr), count(other.count) {
+        if (other.isOwned()) {
+            ptr = owned.data();
+        }
+    }
+
+    FrozenArray(FrozenArray&& other) noexcept = default;
+
+    FrozenArray& operator=(const FrozenArray& other) {
+        if (this != &other) {
+            *this = FrozenArray(other);
+        }
+        return *this;
+    }
+
+    FrozenArray& operator=(FrozenArray&& other) noexcept = default;
+
+    FrozenArray& operator=(std::vector<T>&& values) {
+        owned = std::move(values);
+        ptr = owned.data();
+        count = owned.size();
+        return *this;
+    }
+
+    void attach(const T* data, size_t size) {
+        std::vector<T>().swap(owned);
+        ptr = data;
+        count = size;
+    }
+
+    // 需要原地修改时使用：指向快照映射时先复制到自身持有的内存
+    T* mutableData() {
+        if (!isOwned()) {
+            owned.assign(ptr, ptr + count);
+            ptr = owned.data();
+        }
+        return owned.data();
+    }
+
+    const T& operator[](size_t i) const { return ptr[i]; }
+    const T* data() const { return ptr; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    std::vector<T> owned;
+    const T* ptr = nullptr;
+    size_t count = 0;
+
+    bool isOwned() const { return !owned.empty() && ptr == owned.data(); }
+};
+
+#endif // FROZEN_ARRAY_H
@@ -1,134 +1,1013 @@
 #include "Graph.h"
+#include "MappedFile.h"
+#include "SortedIntersect.h"
+#include "TextKernel.h"
+#include "ThreadPool.h"
 
-void Graph::generateGraph(const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+#include <charconv>
+#include <cstring>
+#include <set>
+
+namespace {
+
+// 转置入边表时源点最多分成的块数：每块需要一个 O(V) 的计数数组，块数不随线程数增长，临时内存保持 O(V)
+const size_t kTransposeChunks = 4;
+
+// 与默认 "C" locale 下 std::isspace 一致
+inline bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// PageRank 降序，得分相同按单词编号
+bool higherRank(const FrozenArray<double>& ranks, Graph::WordId a, Graph::WordId b) {
+    return ranks[a] != ranks[b] ? ranks[a] > ranks[b] : a < b;
+}
+
+struct CsrEntry {
+    uint32_t row;
+    uint32_t column;
+    int weight;
+};
+
+// 把按 (row, column) 升序、原来不存在的边插入 CSR：有新边的行逐项归并，两行之间的部分整段复制
+void insertEntries(const FrozenArray<uint64_t>& offsets, const FrozenArray<uint32_t>& columns,
+                   const FrozenArray<int>& weights, const std::vector<CsrEntry>& entries,
+                   std::vector<uint64_t>& newOffsets, std::vector<uint32_t>& newColumns, std::vector<int>& newWeights) {
+    const size_t rows = offsets.size() - 1;
+    newOffsets.resize(offsets.size());
+    newColumns.resize(columns.size() + entries.size());
+    newWeights.resize(newColumns.size());
+    size_t placed = 0;
+    uint64_t shift = 0;
+    auto copyRows = [&](size_t last) {
+        for (size_t r = placed; r <= last; ++r) {
+            newOffsets[r] = offsets[r] + shift;
+        }
+        std::copy(columns.begin() + offsets[placed], columns.begin() + offsets[last],
+                  newColumns.begin() + newOffsets[placed]);
+        std::copy(weights.begin() + offsets[placed], weights.begin() + offsets[last],
+                  newWeights.begin() + newOffsets[placed]);
+    };
+    for (size_t i = 0; i < entries.size();) {
+        const uint32_t row = entries[i].row;
+        copyRows(row);
+        uint64_t out = newOffsets[row];
+        uint64_t e = offsets[row];
+        auto copyOld = [&](uint64_t end) {
+            for (; e < end; ++e, ++out) {
+                newColumns[out] = columns[e];
+                newWeights[out] = weights[e];
+            }
+        };
+        for (; i < entries.size() && entries[i].row == row; ++i) {
+            copyOld(std::lower_bound(columns.begin() + e, columns.begin() + offsets[row + 1], entries[i].column) -
+                    columns.begin());
+            newColumns[out] = entries[i].column;
+            newWeights[out] = entries[i].weight;
+            ++out;
+            ++shift;
+        }
+        copyOld(offsets[row + 1]);
+        placed = row + 1;
+    }
+    copyRows(rows);
+}
+
+} // namespace
+
+void Graph::generateGraph(const std::string& filePath, unsigned threadCount) {
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
         std::cerr << "无法打开文件: " << filePath << std::endl;
         return;
     }
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threadCount == 1) {
+        nodes.resize(1);
+        ingestText(file.view(), nodes[0]);
+    } else {
+        ingestParallel(file.view(), threadCount);
+    }
+    freeze(threadCount);
+}
+
+// 各行互不影响（prevWord 每行重置），因此可以把文件按行边界切成若干段，
+// 每个线程建立自己的局部边表，并顺手按单词哈希把表项分到各分区的桶里；
+// 随后各线程只遍历属于自己分区的桶，合并出互不相交的分区，直接作为 nodes 交给 freeze()。
+// 边计数只做加法，结果与串行建图完全相同。
+void Graph::ingestParallel(std::string_view text, unsigned threadCount) {
+    std::vector<std::string_view> shards;
+    size_t begin = 0;
+    for (unsigned i = 1; i <= threadCount && begin < text.size(); ++i) {
+        size_t end = text.size() * i / threadCount;
+        if (end < begin) {
+            end = begin;
+        }
+        if (i < threadCount) {
+            size_t newline = text.find('\n', end);
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        } else {
+            end = text.size();
+        }
+        shards.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    // buckets[i][part] 为第 i 段中属于分区 part 的表项
+    const size_t partCount = shards.size();
+    std::vector<WordMap<Node>> shardNodes(shards.size());
+    std::vector<std::vector<std::vector<WordMap<Node>::value_type*>>> buckets(
+        shards.size(), std::vector<std::vector<WordMap<Node>::value_type*>>(partCount));
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        workers.emplace_back([&, i] {
+            ingestText(shards[i], shardNodes[i]);
+            for (auto& entry : shardNodes[i]) {
+                buckets[i][WordHash{}(entry.first) % partCount].push_back(&entry);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
 
-    std::string line, word, prevWord;
-    while (std::getline(file, line)) {
-        line = removePunctuation(line);
-        std::transform(line.begin(), line.end(), line.begin(), ::tolower);
-        std::istringstream iss(line);
-        std::string token;
-        while (iss >> token) {
-            if (token.empty()) {
-                continue;
+    // 不同分区的线程只移动各自桶中的 Node，不修改分片容器本身的结构
+    nodes.assign(partCount, WordMap<Node>());
+    for (size_t part = 0; part < partCount; ++part) {
+        workers.emplace_back([&, part] {
+            for (auto& shardBuckets : buckets) {
+                for (auto* entry : shardBuckets[part]) {
+                    mergeNodes(nodes[part], entry->first, std::move(entry->second));
+                }
             }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void Graph::mergeNodes(WordMap<Node>& target, std::string_view word, Node&& node) {
+    auto it = target.find(word);
+    if (it == target.end()) {
+        target.emplace(std::string(word), std::move(node));
+        return;
+    }
+    auto& edges = it->second.edges;
+    if (edges.empty()) {
+        edges = std::move(node.edges);
+        return;
+    }
+    for (auto& [to, count] : node.edges) {
+        auto edgeIt = edges.find(to);
+        if (edgeIt == edges.end()) {
+            edges.emplace(to, count);
+        } else {
+            edgeIt->second += count;
+        }
+    }
+}
+
+// 逐行处理映射后的文本：先用向量化内核一次性删除标点并转小写，
+// 再按空白切分为 string_view 交给 addEdge。行缓冲区在各行之间复用，
+// 而 prevWord 每行都会重置，所以视图不会跨行失效。
+void Graph::ingestText(std::string_view text, WordMap<Node>& target) {
+    std::string line;
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        size_t rawLength = lineEnd - p;
+        if (line.size() < rawLength) {
+            line.resize(rawLength);
+        }
+        const char* q = line.data();
+        const char* qEnd = q + normalizeText(p, rawLength, line.data());
+
+        std::string_view prevWord;
+        while (q < qEnd) {
+            while (q < qEnd && isSpace(*q)) {
+                ++q;
+            }
+            const char* tokenBegin = q;
+            while (q < qEnd && !isSpace(*q)) {
+                ++q;
+            }
+            if (q == tokenBegin) {
+                break;
+            }
+            std::string_view token(tokenBegin, q - tokenBegin);
             if (!prevWord.empty()) {
-                addEdge(prevWord, token);
+                addEdge(target, prevWord, token);
             }
             prevWord = token;
         }
-        prevWord.clear();
+        p = lineEnd + 1;
     }
-    file.close();
 }
 
-void Graph::addEdge(const std::string& from, const std::string& to) {
-    if (nodes.find(from) == nodes.end()) {
-        nodes[from] = Node();
+void Graph::addEdge(WordMap<Node>& target, std::string_view from, std::string_view to) {
+    auto fromIt = target.find(from);
+    if (fromIt == target.end()) {
+        fromIt = target.emplace(std::string(from), Node()).first;
+    }
+    // 插入新节点可能触发 rehash，迭代器失效但元素引用保持有效
+    auto& edges = fromIt->second.edges;
+    if (target.find(to) == target.end()) {
+        target.emplace(std::string(to), Node());
     }
-    if (nodes.find(to) == nodes.end()) {
-        nodes[to] = Node();
+    auto edgeIt = edges.find(to);
+    if (edgeIt == edges.end()) {
+        edges.emplace(std::string(to), 1);
+    } else {
+        edgeIt->second++;
     }
-    nodes[from].edges[to]++;
+}
+
+// 把暂存表 nodes 合并进 CSR 表示。新旧单词归并后仍按字典序编号，
+// 旧编号到新编号的映射保序，因此旧的行在重新编号后依旧有序。
+// nodes 的各分区没有相同的单词，各自负责的行互不相交：查找新单词、填边、
+// 每行排序合并、构造入边表和别名表都交给线程池并行，只有词表归并和前缀和是串行的线性扫描
+Graph::FreezeDelta Graph::freeze(unsigned threadCount) {
+    FreezeDelta delta;
+    if (std::all_of(nodes.begin(), nodes.end(), [](const WordMap<Node>& part) { return part.empty(); })) {
+        std::vector<WordMap<Node>>().swap(nodes);
+        return delta;
+    }
+
+    ThreadPool pool(threadCount);
+    const size_t partCount = nodes.size();
+    std::vector<std::vector<std::string_view>> partAdded(partCount);
+    pool.run(partCount, [&](size_t part) {
+        for (const auto& [word, node] : nodes[part]) {
+            if (findWord(word) == kNoWord) {
+                partAdded[part].push_back(word);
+            }
+        }
+        std::sort(partAdded[part].begin(), partAdded[part].end());
+    });
+    std::vector<std::string_view> added;
+    for (const auto& list : partAdded) {
+        size_t middle = added.size();
+        added.insert(added.end(), list.begin(), list.end());
+        std::inplace_merge(added.begin(), added.begin() + middle, added.end());
+    }
+    if (added.empty()) {
+        return mergeStagedEdges();
+    }
+
+    size_t oldCount = wordCount();
+    std::vector<char> chars;
+    std::vector<uint64_t> offsets{0};
+    std::vector<WordId> remap(oldCount);
+    chars.reserve(wordPool.size());
+    offsets.reserve(oldCount + added.size() + 1);
+    for (size_t i = 0, j = 0; i < oldCount || j < added.size();) {
+        std::string_view word;
+        if (j == added.size() || (i < oldCount && wordAt(i) < added[j])) {
+            word = wordAt(i);
+            remap[i++] = offsets.size() - 1;
+        } else {
+            word = added[j++];
+        }
+        chars.insert(chars.end(), word.begin(), word.end());
+        offsets.push_back(chars.size());
+    }
+    size_t newCount = offsets.size() - 1;
+
+    std::vector<double> ranks(newCount, 1.0);
+    for (size_t i = 0; i < oldCount; ++i) {
+        ranks[remap[i]] = pageRanks[i];
+    }
+
+    std::vector<uint64_t> rowStart(newCount + 1, 0);
+    for (size_t i = 0; i < oldCount; ++i) {
+        rowStart[remap[i] + 1] += outDegree(i);
+    }
+
+    // 暂存表中的单词都是 nodes 的键，切换到新词表后用 findWord 换算成新编号，之后按编号填边
+    wordPool = std::move(chars);
+    wordOffsets = std::move(offsets);
+    std::vector<std::vector<WordId>> partChanged(partCount);
+    pool.run(partCount, [&](size_t part) {
+        for (const auto& [word, node] : nodes[part]) {
+            WordId id = findWord(word);
+            rowStart[id + 1] += node.edges.size();
+            if (!node.edges.empty()) {
+                partChanged[part].push_back(id);
+            }
+        }
+    });
+    for (const auto& list : partChanged) {
+        delta.changedRows.insert(delta.changedRows.end(), list.begin(), list.end());
+    }
+    for (std::string_view word : added) {
+        delta.addedWords.push_back(findWord(word));
+    }
+    for (size_t i = 0; i < newCount; ++i) {
+        rowStart[i + 1] += rowStart[i];
+    }
+
+    // 行按编号均分成块；先并行填入旧的行，再按分区并行填入暂存的行，每个任务只写自己的行
+    const size_t chunkCount = pool.size() == 1 ? 1 : pool.size() * 8;
+    auto rowRange = [](size_t chunk, size_t chunks, size_t rows) {
+        return std::make_pair(rows * chunk / chunks, rows * (chunk + 1) / chunks);
+    };
+    std::vector<std::pair<WordId, int>> edges(rowStart[newCount]);
+    std::vector<uint64_t> cursor(rowStart.begin(), rowStart.end() - 1);
+    pool.run(chunkCount, [&](size_t chunk) {
+        auto [first, last] = rowRange(chunk, chunkCount, oldCount);
+        for (size_t i = first; i < last; ++i) {
+            for (uint64_t e = outOffsets[i]; e < outOffsets[i + 1]; ++e) {
+                edges[cursor[remap[i]]++] = {remap[outTargets[e]], outWeights[e]};
+            }
+        }
+    });
+    pool.run(partCount, [&](size_t part) {
+        for (const auto& [word, node] : nodes[part]) {
+            WordId from = findWord(word);
+            for (const auto& [to, count] : node.edges) {
+                edges[cursor[from]++] = {findWord(to), count};
+            }
+        }
+        WordMap<Node>().swap(nodes[part]);
+    });
+    std::vector<WordMap<Node>>().swap(nodes);
+
+    // 每行按目标编号排序并合并新旧两部分中相同的边，合并后的边留在本行开头，再整体紧缩
+    std::vector<uint64_t> newOutOffsets(newCount + 1, 0);
+    pool.run(chunkCount, [&](size_t chunk) {
+        auto [first, last] = rowRange(chunk, chunkCount, newCount);
+        for (size_t u = first; u < last; ++u) {
+            auto rowBegin = edges.begin() + rowStart[u];
+            auto rowEnd = edges.begin() + rowStart[u + 1];
+            std::sort(rowBegin, rowEnd);
+            auto kept = rowBegin;
+            for (auto it = rowBegin; it != rowEnd; ++it) {
+                if (kept != rowBegin && (kept - 1)->first == it->first) {
+                    (kept - 1)->second += it->second;
+                } else {
+                    *kept++ = *it;
+                }
+            }
+            newOutOffsets[u + 1] = kept - rowBegin;
+        }
+    });
+    for (size_t i = 0; i < newCount; ++i) {
+        newOutOffsets[i + 1] += newOutOffsets[i];
+    }
+    std::vector<WordId> targets(newOutOffsets[newCount]);
+    std::vector<int> weights(targets.size());
+    pool.run(chunkCount, [&](size_t chunk) {
+        auto [first, last] = rowRange(chunk, chunkCount, newCount);
+        for (size_t u = first; u < last; ++u) {
+            for (uint64_t i = 0; i < newOutOffsets[u + 1] - newOutOffsets[u]; ++i) {
+                targets[newOutOffsets[u] + i] = edges[rowStart[u] + i].first;
+                weights[newOutOffsets[u] + i] = edges[rowStart[u] + i].second;
+            }
+        }
+    });
+
+    // 入边表：源点按块切分，每块先统计指向各目标的边数。每个目标的入边行中各块占连续的一段、按块的顺序排列，
+    // 块内按源点顺序写入，因此每行入边天然有序
+    const size_t sourceChunks = std::min<size_t>(pool.size(), kTransposeChunks);
+    std::vector<std::vector<uint64_t>> slots(sourceChunks, std::vector<uint64_t>(newCount, 0));
+    pool.run(sourceChunks, [&](size_t chunk) {
+        auto [first, last] = rowRange(chunk, sourceChunks, newCount);
+        for (uint64_t e = newOutOffsets[first]; e < newOutOffsets[last]; ++e) {
+            slots[chunk][targets[e]]++;
+        }
+    });
+    std::vector<uint64_t> newInOffsets(newCount + 1, 0);
+    for (size_t v = 0; v < newCount; ++v) {
+        uint64_t next = newInOffsets[v];
+        for (auto& counts : slots) {
+            uint64_t count = counts[v];
+            counts[v] = next;
+            next += count;
+        }
+        newInOffsets[v + 1] = next;
+    }
+    std::vector<WordId> sources(targets.size());
+    std::vector<int> sourceWeights(targets.size());
+    pool.run(sourceChunks, [&](size_t chunk) {
+        auto [first, last] = rowRange(chunk, sourceChunks, newCount);
+        for (size_t u = first; u < last; ++u) {
+            for (uint64_t e = newOutOffsets[u]; e < newOutOffsets[u + 1]; ++e) {
+                uint64_t slot = slots[chunk][targets[e]]++;
+                sources[slot] = static_cast<WordId>(u);
+                sourceWeights[slot] = weights[e];
+            }
+        }
+    });
+
+    outOffsets = std::move(newOutOffsets);
+    outTargets = std::move(targets);
+    outWeights = std::move(weights);
+    inOffsets = std::move(newInOffsets);
+    inSources = std::move(sources);
+    inWeights = std::move(sourceWeights);
+    pageRanks = std::move(ranks);
+    pageRankDamping = 0.0;
+    rankOrder = std::vector<WordId>();
+    rankBelow = std::vector<WordId>();
+    landmarks = std::vector<WordId>();
+    landmarkFrom = std::vector<int64_t>();
+    landmarkTo = std::vector<int64_t>();
+    snapshot.reset();
+    rebuildComponents();
+    rebuildAliasTables(threadCount);
+    return delta;
+}
+
+// 暂存表中没有新单词时编号不变：已有的边原地累加权重（PageRank 不看权重，只有别名表要更新），
+// 新边逐行归并插入。新边不改变分量之间的可达关系时分量保持不变，否则重算。
+// 排名索引与 pageRanks 保持一致，不在这里清除，由调用方决定是否刷新
+Graph::FreezeDelta Graph::mergeStagedEdges() {
+    std::vector<CsrEntry> staged;
+    for (const WordMap<Node>& part : nodes) {
+        for (const auto& [word, node] : part) {
+            WordId from = findWord(word);
+            for (const auto& [to, count] : node.edges) {
+                staged.push_back({from, findWord(to), count});
+            }
+        }
+    }
+    std::vector<WordMap<Node>>().swap(nodes);
+    std::sort(staged.begin(), staged.end(), [](const CsrEntry& a, const CsrEntry& b) {
+        return a.row != b.row ? a.row < b.row : a.column < b.column;
+    });
+
+    FreezeDelta delta;
+    std::vector<WordId> weightedRows;
+    std::vector<CsrEntry> added;
+    int* weights = outWeights.mutableData();
+    int* sourceWeights = inWeights.mutableData();
+    for (const CsrEntry& edge : staged) {
+        if (weightedRows.empty() || weightedRows.back() != edge.row) {
+            weightedRows.push_back(edge.row);
+        }
+        const WordId* rowEnd = outTargets.begin() + outOffsets[edge.row + 1];
+        const WordId* it = std::lower_bound(outTargets.begin() + outOffsets[edge.row], rowEnd, edge.column);
+        if (it == rowEnd || *it != edge.column) {
+            added.push_back(edge);
+            if (delta.changedRows.empty() || delta.changedRows.back() != edge.row) {
+                delta.changedRows.push_back(edge.row);
+            }
+            continue;
+        }
+        weights[it - outTargets.begin()] += edge.weight;
+        const WordId* columnBegin = inSources.begin() + inOffsets[edge.column];
+        const WordId* columnEnd = inSources.begin() + inOffsets[edge.column + 1];
+        sourceWeights[std::lower_bound(columnBegin, columnEnd, edge.row) - inSources.begin()] += edge.weight;
+    }
+
+    // 新边 u -> v 只有在 u 的分量原本到不了 v 的分量时，才会合并分量或改变可达关系。
+    // 每条边只做 O(1) 的判定：有闭包时精确；没有时只认标签能确定的可达，其余情况直接重算一次分量，
+    // 重算是 O(V + E)，不会因为新边多而逐条在凝聚图上搜索
+    bool componentsChanged = std::any_of(added.begin(), added.end(), [this](const CsrEntry& edge) {
+        uint32_t from = componentOfWord[edge.row];
+        uint32_t to = componentOfWord[edge.column];
+        if (from == to) return false;
+        return componentReach.empty() ? !treeReaches(from, to) : !mayReach(from, to);
+    });
+
+    if (added.empty()) {
+        updateAliasTables(weightedRows, nullptr);
+    } else {
+        std::vector<uint64_t> offsets;
+        std::vector<WordId> columns;
+        std::vector<int> columnWeights;
+        insertEntries(outOffsets, outTargets, outWeights, added, offsets, columns, columnWeights);
+        FrozenArray<uint64_t> oldOffsets = std::move(outOffsets);
+        outOffsets = std::move(offsets);
+        outTargets = std::move(columns);
+        outWeights = std::move(columnWeights);
+
+        for (CsrEntry& edge : added) {
+            std::swap(edge.row, edge.column);
+        }
+        std::sort(added.begin(), added.end(), [](const CsrEntry& a, const CsrEntry& b) {
+            return a.row != b.row ? a.row < b.row : a.column < b.column;
+        });
+        insertEntries(inOffsets, inSources, inWeights, added, offsets, columns, columnWeights);
+        inOffsets = std::move(offsets);
+        inSources = std::move(columns);
+        inWeights = std::move(columnWeights);
+
+        updateAliasTables(weightedRows, &oldOffsets);
+        pageRankDamping = 0.0;
+    }
+
+    landmarks = std::vector<WordId>();
+    landmarkFrom = std::vector<int64_t>();
+    landmarkTo = std::vector<int64_t>();
+    if (componentsChanged) {
+        rebuildComponents();
+    }
+    return delta;
+}
+
+Graph::WordId Graph::findWord(std::string_view word) const {
+    size_t lo = 0;
+    size_t hi = wordCount();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (wordAt(mid) < word) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < wordCount() && wordAt(lo) == word ? static_cast<WordId>(lo) : kNoWord;
 }
 
 void Graph::showDirectedGraph() const {
-    for (const auto& node : nodes) {
-        std::cout << node.first << ": ";
-        for (const auto& edge : node.second.edges) {
-            std::cout << edge.first << "(" << edge.second << ") ";
+    showDirectedGraph(GraphDumpOptions{});
+}
+
+// 先按 options 选出要输出的单词，再逐行格式化到同一个大缓冲区，攒满后整块写出；
+// 分页时每页结束写出缓冲区并等待 input 中的一行
+void Graph::showDirectedGraph(const GraphDumpOptions& options, std::ostream& output, std::istream& input) const {
+    const size_t numNodes = wordCount();
+    const size_t count = options.limit == 0 ? numNodes : std::min(options.limit, numNodes);
+    std::vector<WordId> order;
+    if (options.order == GraphOrder::PageRank && rankOrder.size() == numNodes) {
+        order.assign(rankOrder.begin(), rankOrder.begin() + count);
+    } else if (options.order != GraphOrder::Word) {
+        order.resize(numNodes);
+        for (size_t id = 0; id < numNodes; ++id) {
+            order[id] = static_cast<WordId>(id);
+        }
+        auto before = [this, &options](WordId a, WordId b) {
+            if (options.order == GraphOrder::PageRank) {
+                return higherRank(pageRanks, a, b);
+            }
+            return outDegree(a) != outDegree(b) ? outDegree(a) > outDegree(b) : a < b;
+        };
+        std::partial_sort(order.begin(), order.begin() + count, order.end(), before);
+        order.resize(count);
+    }
+
+    const size_t flushSize = 1 << 20;
+    std::string buffer;
+    buffer.reserve(flushSize + 4096);
+    auto flush = [&]() {
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    };
+    char digits[16];
+    for (size_t i = 0; i < count; ++i) {
+        WordId u = order.empty() ? static_cast<WordId>(i) : order[i];
+        buffer += wordAt(u);
+        buffer += ": ";
+        for (uint64_t e = outOffsets[u]; e < outOffsets[u + 1]; ++e) {
+            buffer += wordAt(outTargets[e]);
+            buffer += '(';
+            buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), outWeights[e]).ptr);
+            buffer += ") ";
+        }
+        buffer += '\n';
+
+        bool pageEnd = options.pageSize > 0 && (i + 1) % options.pageSize == 0 && i + 1 < count;
+        if (pageEnd) {
+            buffer += "-- 第 " + std::to_string((i + 1) / options.pageSize) + " 页，回车继续，输入 q 结束 --\n";
+            flush();
+            output.flush();
+            std::string line;
+            if (!std::getline(input, line) || line == "q") {
+                return;
+            }
+        } else if (buffer.size() >= flushSize) {
+            flush();
         }
-        std::cout << std::endl;
     }
+    flush();
+    output.flush();
 }
 
+// 桥接词 b 满足 word1 -> b 且 b -> word2，即 word1 的出边表与 word2 的入边表的交集。
+// 两张表都按编号升序，交集结果也按编号（即字典序）输出
 std::vector<std::string> Graph::queryBridgeWords(const std::string& word1, const std::string& word2) const {
     std::vector<std::string> bridgeWords;
-    if (nodes.find(word1) == nodes.end() || nodes.find(word2) == nodes.end()) {
+    WordId from = findWord(word1);
+    WordId to = findWord(word2);
+    if (from == kNoWord || to == kNoWord) {
         return bridgeWords;
     }
-    for (const auto& edge1 : nodes.at(word1).edges) {
-        if (nodes.at(edge1.first).edges.find(word2) != nodes.at(edge1.first).edges.end()) {
-            bridgeWords.push_back(edge1.first);
-        }
+    const WordId* successors = outTargets.data() + outOffsets[from];
+    const WordId* predecessors = inSources.data() + inOffsets[to];
+    std::vector<WordId> common(std::min(outDegree(from), inOffsets[to + 1] - inOffsets[to]));
+    common.resize(intersectSorted(successors, outDegree(from), predecessors, inOffsets[to + 1] - inOffsets[to], common.data()));
+    bridgeWords.reserve(common.size());
+    for (WordId bridge : common) {
+        bridgeWords.emplace_back(wordAt(bridge));
     }
     return bridgeWords;
 }
 
-std::string Graph::generateNewText(const std::string& inputText) const {
-    std::istringstream iss(inputText);
-    std::string word, prevWord, result;
-    while (iss >> word) {
-        word = removePunctuation(word);
-        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-        if (word.empty()) {
-            continue;
+void Graph::queryBridgeWordsBatch(std::span<const WordPair> pairs, BridgeBatch& result) const {
+    std::unordered_map<std::string_view, WordId> resolved;
+    auto resolve = [&](std::string_view word) {
+        auto it = resolved.find(word);
+        if (it == resolved.end()) {
+            it = resolved.emplace(word, findWord(word)).first;
         }
-        if (!prevWord.empty()) {
-            auto bridgeWords = queryBridgeWords(prevWord, word);
-            if (!bridgeWords.empty()) {
-                result += " " + bridgeWords[0];
-            }
+        return it->second;
+    };
+
+    // 下标用 64 位：批量超过 2^32 对时截断会把结果写到别的对上
+    struct PairIds {
+        WordId from;
+        WordId to;
+        uint64_t index;
+    };
+    std::vector<PairIds> grouped;
+    grouped.reserve(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        WordId from = resolve(pairs[i].first);
+        WordId to = resolve(pairs[i].second);
+        if (from != kNoWord && to != kNoWord) {
+            grouped.push_back({from, to, i});
         }
-        result += " " + word;
-        prevWord = word;
     }
-    if (!result.empty() && result.front() == ' ') {
-        result.erase(result.begin());
+    std::sort(grouped.begin(), grouped.end(), [](const PairIds& a, const PairIds& b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+
+    // 按分组顺序求交集，先记下每对结果在临时缓冲区中的位置，最后按输入顺序拼接
+    std::vector<WordId> scratch;
+    std::vector<std::pair<uint64_t, uint64_t>> spans(pairs.size(), {0, 0});
+    for (size_t g = 0; g < grouped.size();) {
+        WordId from = grouped[g].from;
+        const WordId* successors = outTargets.data() + outOffsets[from];
+        size_t successorCount = outDegree(from);
+        for (; g < grouped.size() && grouped[g].from == from; ++g) {
+            WordId to = grouped[g].to;
+            size_t predecessorCount = inOffsets[to + 1] - inOffsets[to];
+            size_t start = scratch.size();
+            scratch.resize(start + std::min(successorCount, predecessorCount));
+            size_t found = intersectSorted(successors, successorCount, inSources.data() + inOffsets[to], predecessorCount,
+                                           scratch.data() + start);
+            scratch.resize(start + found);
+            spans[grouped[g].index] = {start, found};
+        }
     }
+
+    result.offsets.assign(pairs.size() + 1, 0);
+    result.bridges.clear();
+    result.bridges.reserve(scratch.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        auto [start, count] = spans[i];
+        result.bridges.insert(result.bridges.end(), scratch.begin() + start, scratch.begin() + start + count);
+        result.offsets[i + 1] = result.bridges.size();
+    }
+}
+
+std::string Graph::generateNewText(const std::string& inputText) const {
+    std::string result;
+    std::string scratch;
+    rewriteTokens(inputText, result, scratch);
     return result;
 }
 
-std::string Graph::calcShortestPath(const std::string& word1, const std::string& word2) const {
-    if (nodes.find(word1) == nodes.end() || nodes.find(word2) == nodes.end()) {
-        return "No path found";
+// 把 text 视为一串以空白分隔的单词（换行也是空白），在相邻两词之间插入编号最小的桥接词，
+// 单词之间以单个空格分隔追加到 out。桥接词查找在第一个公共元素处即停止
+void Graph::rewriteTokens(std::string_view text, std::string& out, std::string& scratch) const {
+    if (scratch.size() < text.size()) {
+        scratch.resize(text.size());
     }
+    const char* p = scratch.data();
+    const char* end = p + normalizeText(text.data(), text.size(), scratch.data());
 
-    std::unordered_map<std::string, double> distances;
-    std::unordered_map<std::string, std::string> predecessors;
-    std::priority_queue<std::pair<double, std::string>, std::vector<std::pair<double, std::string>>, std::greater<>> pq;
+    bool first = true;
+    WordId prevId = kNoWord;
+    while (p < end) {
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        const char* tokenBegin = p;
+        while (p < end && !isSpace(*p)) {
+            ++p;
+        }
+        if (p == tokenBegin) {
+            break;
+        }
+        std::string_view word(tokenBegin, p - tokenBegin);
+        WordId id = findWord(word);
 
-    for (const auto& node : nodes) {
-        distances[node.first] = std::numeric_limits<double>::infinity();
+        WordId bridge;
+        if (prevId != kNoWord && id != kNoWord &&
+            firstCommon(outTargets.data() + outOffsets[prevId], outDegree(prevId),
+                        inSources.data() + inOffsets[id], inOffsets[id + 1] - inOffsets[id], bridge)) {
+            out += ' ';
+            out.append(wordAt(bridge));
+        }
+        if (!first) {
+            out += ' ';
+        }
+        out.append(word);
+        first = false;
+        prevId = id;
     }
-    distances[word1] = 0;
-    pq.push({0, word1});
+}
 
-    while (!pq.empty()) {
-        auto [currentDist, currentWord] = pq.top();
-        pq.pop();
+// 逐行改写；以换行结尾的行输出后也补换行，最后一行没有换行时输出也不加
+void Graph::rewriteLines(std::string_view text, std::string& out) const {
+    std::string scratch;
+    while (!text.empty()) {
+        size_t newline = text.find('\n');
+        rewriteTokens(text.substr(0, newline), out, scratch);
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        out += '\n';
+        text.remove_prefix(newline + 1);
+    }
+}
 
-        if (currentWord == word2) break;
+void Graph::generateNewText(std::istream& input, std::ostream& output, unsigned threadCount) const {
+    const size_t chunkSize = 1 << 20;
+    ThreadPool pool(threadCount);
+    std::vector<std::string> inputs(pool.size());
+    std::vector<std::string> outputs(pool.size());
+    std::string carry;
+    bool eof = false;
 
-        for (const auto& [neighbor, weight] : nodes.at(currentWord).edges) {
-            double newDist = currentDist + weight;
-            if (newDist < distances[neighbor]) {
-                distances[neighbor] = newDist;
-                predecessors[neighbor] = currentWord;
-                pq.push({newDist, neighbor});
+    while (!eof) {
+        // 每块在最后一个换行处截断，剩余部分留给下一块；超过块大小的长行会继续累积
+        size_t filled = 0;
+        while (filled < inputs.size() && !eof) {
+            std::string& chunk = inputs[filled];
+            chunk.swap(carry);
+            carry.clear();
+            size_t kept = chunk.size();
+            chunk.resize(kept + chunkSize);
+            input.read(chunk.data() + kept, chunkSize);
+            chunk.resize(kept + input.gcount());
+            if (static_cast<size_t>(input.gcount()) < chunkSize) {
+                eof = true;
+            } else {
+                size_t newline = chunk.rfind('\n');
+                if (newline == std::string::npos) {
+                    carry.swap(chunk);
+                    continue;
+                }
+                carry.assign(chunk, newline + 1);
+                chunk.resize(newline + 1);
             }
+            ++filled;
+        }
+
+        pool.run(filled, [&](size_t i) {
+            outputs[i].clear();
+            rewriteLines(inputs[i], outputs[i]);
+        });
+        for (size_t i = 0; i < filled; ++i) {
+            output.write(outputs[i].data(), static_cast<std::streamsize>(outputs[i].size()));
         }
     }
+}
+
+bool Graph::generateNewTextFile(const std::string& inputPath, const std::string& outputPath, unsigned threadCount) const {
+    MappedFile file(inputPath);
+    if (!file.isOpen()) {
+        std::cerr << "无法打开文件: " << inputPath << std::endl;
+        return false;
+    }
+    std::ofstream outFile(outputPath, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "无法打开输出文件: " << outputPath << std::endl;
+        return false;
+    }
+
+    // 直接在映射上按行边界切块，不复制输入
+    const size_t chunkSize = 1 << 20;
+    std::string_view text = file.view();
+    ThreadPool pool(threadCount);
+    std::vector<std::string_view> chunks(pool.size());
+    std::vector<std::string> outputs(pool.size());
+    while (!text.empty()) {
+        size_t filled = 0;
+        for (; filled < chunks.size() && !text.empty(); ++filled) {
+            size_t end = text.size() <= chunkSize ? text.size() : text.find('\n', chunkSize);
+            end = end == std::string_view::npos ? text.size() : std::min(text.size(), end + 1);
+            chunks[filled] = text.substr(0, end);
+            text.remove_prefix(end);
+        }
+        pool.run(filled, [&](size_t i) {
+            outputs[i].clear();
+            rewriteLines(chunks[i], outputs[i]);
+        });
+        for (size_t i = 0; i < filled; ++i) {
+            outFile.write(outputs[i].data(), static_cast<std::streamsize>(outputs[i].size()));
+        }
+    }
+    if (!outFile) {
+        std::cerr << "写入输出文件失败: " << outputPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 每个线程各自持有几个工作区，供同一线程上的后续查询复用；不同 Graph 对象之间共用也安全，
+// 因为每次查询都会开启新的轮次
+PathWorkspace& Graph::pathWorkspace(size_t slot) {
+    thread_local PathWorkspace workspaces[2];
+    return workspaces[slot];
+}
+
+// 从 source 出发的 Dijkstra，弹出 target 时停止（target 为 kNoWord 时求出全部可达节点）；
+// reverse 为 true 时沿入边搜索，得到各节点到 source 的距离。
+// 边权是不小于 1 的整数计数，因此距离用基数堆按整数排序。
+// 多条最短路并列时，前驱取 (距离, 编号) 最小的那个，与原先按 (距离, 编号) 出堆的结果一致，
+// 且与同距离节点的出堆顺序无关
+void Graph::runDijkstra(WordId source, WordId target, PathWorkspace& workspace, bool reverse) const {
+    const FrozenArray<uint64_t>& offsets = reverse ? inOffsets : outOffsets;
+    const FrozenArray<WordId>& neighbors = reverse ? inSources : outTargets;
+    const FrozenArray<int>& weights = reverse ? inWeights : outWeights;
+
+    workspace.begin(wordCount());
+    workspace.set(source, 0, kNoWord);
+    workspace.heap.push(0, source);
+
+    while (!workspace.heap.empty()) {
+        auto [key, current] = workspace.heap.pop();
+        int64_t currentDist = static_cast<int64_t>(key);
+        if (currentDist > workspace.distance(current)) continue;
+        if (current == target) break;
+
+        for (uint64_t e = offsets[current]; e < offsets[current + 1]; ++e) {
+            workspace.relax(neighbors[e], currentDist + weights[e], current, currentDist);
+        }
+    }
+}
+
+// 双向 Dijkstra：forward 沿出边从 source 搜索，backward 沿入边从 target 搜索，每次推进堆较小的一侧。
+// best 记录两侧相接得到的最短距离，当两侧堆顶之和严格大于 best 时停止，此时 best 即最短距离，
+// 且每个位于最短路上的节点要么已被正向确定，要么已被反向确定。
+// 随后正向搜索继续推进，但只展开满足 正向距离 + 反向距离 <= best 的节点（恰为最短路上的节点），
+// 直到弹出 target。这样 forward 中的前驱与单向 runDijkstra 的结果完全相同。
+// 有地标表时用下界剪枝：出堆节点的距离加上剩余距离的下界已超过 best 时不可能在最短路上，不再展开；
+// 下界断定不可达时同样不展开，source 到 target 本身不可达时直接返回
+bool Graph::runBidirectional(WordId source, WordId target, PathWorkspace& forward, PathWorkspace& backward) const {
+    forward.begin(wordCount());
+    backward.begin(wordCount());
+    forward.set(source, 0, kNoWord);
+    backward.set(target, 0, kNoWord);
+    if (source == target) {
+        return true;
+    }
+
+    // 分量可达性在 O(1) 内拒绝不可达的查询，并在搜索中跳过到不了 target（或 source 到不了）的分量
+    const uint32_t sourceComponent = componentOfWord[source];
+    const uint32_t targetComponent = componentOfWord[target];
+    if (!mayReach(sourceComponent, targetComponent)) {
+        return false;
+    }
+    const int64_t infinity = PathWorkspace::kInfinity;
+    if (!landmarks.empty() && landmarkBound(source, target) == infinity) {
+        return false;
+    }
+    // 距离为 reachDist 的已确定节点是否可能在最短路上；from -> to 为该节点一侧剩余的路程
+    auto mayImprove = [&](int64_t reachDist, int64_t best, WordId from, WordId to) {
+        if (landmarks.empty()) {
+            return true;
+        }
+        int64_t bound = landmarkBound(from, to);
+        return bound != infinity && reachDist + bound <= best;
+    };
+    forward.heap.push(0, source);
+    backward.heap.push(0, target);
+
+    int64_t best = infinity;
+    while (!forward.heap.empty() && !backward.heap.empty()) {
+        if (best != infinity && static_cast<int64_t>(forward.heap.topKey() + backward.heap.topKey()) > best) {
+            break;
+        }
+        if (forward.heap.size() <= backward.heap.size()) {
+            auto [key, current] = forward.heap.pop();
+            int64_t currentDist = static_cast<int64_t>(key);
+            if (currentDist > forward.distance(current) || !mayImprove(currentDist, best, current, target)) continue;
+            for (uint64_t e = outOffsets[current]; e < outOffsets[current + 1]; ++e) {
+                WordId neighbor = outTargets[e];
+                if (!mayReach(componentOfWord[neighbor], targetComponent)) continue;
+                int64_t newDist = currentDist + outWeights[e];
+                forward.relax(neighbor, newDist, current, currentDist);
+                if (backward.reached(neighbor)) {
+                    best = std::min(best, newDist + backward.distance(neighbor));
+                }
+            }
+        } else {
+            auto [key, current] = backward.heap.pop();
+            int64_t currentDist = static_cast<int64_t>(key);
+            if (currentDist > backward.distance(current) || !mayImprove(currentDist, best, source, current)) continue;
+            for (uint64_t e = inOffsets[current]; e < inOffsets[current + 1]; ++e) {
+                WordId neighbor = inSources[e];
+                if (!mayReach(sourceComponent, componentOfWord[neighbor])) continue;
+                int64_t newDist = currentDist + inWeights[e];
+                if (newDist < backward.distance(neighbor)) {
+                    backward.set(neighbor, newDist, current);
+                    backward.heap.push(newDist, neighbor);
+                }
+                if (forward.reached(neighbor)) {
+                    best = std::min(best, newDist + forward.distance(neighbor));
+                }
+            }
+        }
+    }
+    if (best == infinity) {
+        return false;
+    }
 
-    if (distances[word2] == std::numeric_limits<double>::infinity()) {
+    while (!forward.heap.empty()) {
+        auto [key, current] = forward.heap.pop();
+        int64_t currentDist = static_cast<int64_t>(key);
+        if (currentDist > forward.distance(current)) continue;
+        if (current == target) break;
+        // 只有最短路上的节点才可能是最短路上节点的前驱，其余节点不必展开
+        if (!backward.reached(current) || currentDist + backward.distance(current) > best) continue;
+        for (uint64_t e = outOffsets[current]; e < outOffsets[current + 1]; ++e) {
+            WordId neighbor = outTargets[e];
+            int64_t newDist = currentDist + outWeights[e];
+            if (backward.reached(neighbor) && newDist + backward.distance(neighbor) <= best) {
+                forward.relax(neighbor, newDist, current, currentDist);
+            }
+        }
+    }
+    return true;
+}
+
+void Graph::fillPathTree(WordId source, const PathWorkspace& workspace, ShortestPathTree& tree) const {
+    const size_t numNodes = wordCount();
+    tree.source = source;
+    tree.distances.resize(numNodes);
+    tree.predecessors.resize(numNodes);
+    for (size_t v = 0; v < numNodes; ++v) {
+        bool reached = workspace.reached(static_cast<WordId>(v));
+        tree.distances[v] = reached ? workspace.distance(static_cast<WordId>(v)) : kUnreachable;
+        tree.predecessors[v] = reached ? workspace.predecessor(static_cast<WordId>(v)) : kNoWord;
+    }
+}
+
+Graph::ShortestPathTree Graph::shortestPathsFrom(const std::string& word) const {
+    ShortestPathTree tree;
+    WordId source = findWord(word);
+    if (source == kNoWord) {
+        return tree;
+    }
+    PathWorkspace& workspace = pathWorkspace(0);
+    runDijkstra(source, kNoWord, workspace);
+    fillPathTree(source, workspace, tree);
+    return tree;
+}
+
+// 每个源点是一个任务，由线程池的原子计数器分配，源点之间耗时差异很大时也能保持均衡
+void Graph::shortestPathsFromMany(std::span<const WordId> sources,
+                                  const std::function<void(size_t index, const ShortestPathTree& tree)>& visit,
+                                  unsigned threadCount) const {
+    const size_t taskCount = sources.empty() ? wordCount() : sources.size();
+    ThreadPool pool(threadCount);
+    pool.run(taskCount, [&](size_t index) {
+        thread_local ShortestPathTree tree;
+        WordId source = sources.empty() ? static_cast<WordId>(index) : sources[index];
+        PathWorkspace& workspace = pathWorkspace(0);
+        runDijkstra(source, kNoWord, workspace);
+        fillPathTree(source, workspace, tree);
+        visit(index, tree);
+    });
+}
+
+std::string Graph::calcShortestPath(const std::string& word1, const std::string& word2) const {
+    WordId source = findWord(word1);
+    WordId target = findWord(word2);
+    if (source == kNoWord || target == kNoWord) {
         return "No path found";
     }
 
-    std::vector<std::string> path;
-    for (std::string at = word2; at != word1; at = predecessors[at]) {
+    PathWorkspace& workspace = pathWorkspace(0);
+    if (!runBidirectional(source, target, workspace, pathWorkspace(1))) {
+        return "No path found";
+    }
+
+    std::vector<WordId> path;
+    for (WordId at = target; at != source; at = workspace.predecessor(at)) {
         path.push_back(at);
     }
-    path.push_back(word1);
+    path.push_back(source);
     std::reverse(path.begin(), path.end());
 
     std::ostringstream oss;
     for (size_t i = 0; i < path.size(); ++i) {
-        oss << path[i];
+        oss << wordAt(path[i]);
         if (i < path.size() - 1) {
             oss << " -> ";
         }
@@ -136,119 +1015,469 @@ std::string Graph::calcShortestPath(const std::string& word1, const std::string&
     return oss.str();
 }
 
-void Graph::calculatePageRank(double d) {
-    size_t numNodes = nodes.size();
+// 出边表按编号升序，二分查找 from -> to 的权重；边不存在时返回 0
+int Graph::edgeWeight(WordId from, WordId to) const {
+    const WordId* begin = outTargets.data() + outOffsets[from];
+    const WordId* end = outTargets.data() + outOffsets[from + 1];
+    const WordId* it = std::lower_bound(begin, end, to);
+    return it != end && *it == to ? outWeights[it - outTargets.data()] : 0;
+}
+
+// Yen 算法：每得到一条路径，就依次以它的每个节点为偏离点，屏蔽已选路径中共享同一前缀的下一条边
+// 以及前缀上的其余节点，求偏离点到终点的最短路，拼成候选路径。
+// 所有偏离搜索共用一棵反向最短路树：原图上到 target 的距离是删边后距离的一致下界，
+// 因此偏离搜索用它做 A* 只沿最短方向推进；树外的节点到不了 target，直接跳过。
+// 工作区按轮次复用，前缀节点随偏离点前移逐个屏蔽，每次偏离搜索的初始化都是 O(1)
+std::vector<Graph::WeightedPath> Graph::kShortestPaths(const std::string& word1, const std::string& word2, size_t k) const {
+    std::vector<WeightedPath> result;
+    WordId source = findWord(word1);
+    WordId target = findWord(word2);
+    if (source == kNoWord || target == kNoWord || k == 0) {
+        return result;
+    }
+
+    PathWorkspace& workspace = pathWorkspace(0);
+    PathWorkspace& toTarget = pathWorkspace(1);
+    if (!runBidirectional(source, target, workspace, toTarget)) {
+        return result;
+    }
+    WeightedPath first;
+    first.weight = workspace.distance(target);
+    for (WordId at = target; at != source; at = workspace.predecessor(at)) {
+        first.words.push_back(at);
+    }
+    first.words.push_back(source);
+    std::reverse(first.words.begin(), first.words.end());
+    result.push_back(std::move(first));
+    if (source == target) {
+        return result;
+    }
+    runDijkstra(target, kNoWord, toTarget, true);
+
+    std::vector<char> blocked(wordCount(), 0);
+    std::vector<WordId> blockedNext;
+    auto spurSearch = [&](WordId spur) {
+        workspace.begin(wordCount());
+        workspace.set(spur, 0, kNoWord);
+        workspace.heap.push(toTarget.distance(spur), spur);
+        while (!workspace.heap.empty()) {
+            auto [key, current] = workspace.heap.pop();
+            int64_t currentDist = workspace.distance(current);
+            if (static_cast<int64_t>(key) > currentDist + toTarget.distance(current)) continue;
+            if (current == target) return true;
+            for (uint64_t e = outOffsets[current]; e < outOffsets[current + 1]; ++e) {
+                WordId neighbor = outTargets[e];
+                if (blocked[neighbor] || !toTarget.reached(neighbor)) continue;
+                if (current == spur && std::find(blockedNext.begin(), blockedNext.end(), neighbor) != blockedNext.end()) continue;
+                int64_t newDist = currentDist + outWeights[e];
+                if (newDist < workspace.distance(neighbor)) {
+                    workspace.set(neighbor, newDist, current);
+                    workspace.heap.push(newDist + toTarget.distance(neighbor), neighbor);
+                }
+            }
+        }
+        return false;
+    };
+
+    // 候选集合按 (权重, 编号序列) 排序并去重
+    std::set<std::pair<int64_t, std::vector<WordId>>> candidates;
+    while (result.size() < k) {
+        const std::vector<WordId> previous = result.back().words;
+        int64_t rootWeight = 0;
+        for (size_t i = 0; i + 1 < previous.size(); ++i) {
+            WordId spur = previous[i];
+            if (i > 0) {
+                blocked[previous[i - 1]] = 1;
+                rootWeight += edgeWeight(previous[i - 1], spur);
+            }
+            blockedNext.clear();
+            for (const WeightedPath& path : result) {
+                if (path.words.size() > i + 1 && std::equal(previous.begin(), previous.begin() + i + 1, path.words.begin())) {
+                    blockedNext.push_back(path.words[i + 1]);
+                }
+            }
+            if (!toTarget.reached(spur) || !spurSearch(spur)) continue;
+
+            std::vector<WordId> words(previous.begin(), previous.begin() + i);
+            size_t rootSize = words.size();
+            for (WordId at = target; at != spur; at = workspace.predecessor(at)) {
+                words.push_back(at);
+            }
+            words.push_back(spur);
+            std::reverse(words.begin() + rootSize, words.end());
+            candidates.emplace(rootWeight + workspace.distance(target), std::move(words));
+        }
+        for (WordId word : previous) {
+            blocked[word] = 0;
+        }
+
+        if (candidates.empty()) break;
+        auto best = candidates.begin();
+        result.push_back({best->second, best->first});
+        candidates.erase(best);
+    }
+    return result;
+}
+
+// 拉取式 PageRank：每轮先算出每个节点沿每条出边分出的份额，
+// 再沿入边表把份额累加到目标节点。所有数组按单词编号连续存放，每轮 O(V + E)。
+// 节点按 "节点数 + 入边数" 均匀切块交给线程池；每个节点的累加顺序固定，
+// 收敛判断只做逻辑或，因此结果与线程数无关
+void Graph::calculatePageRank(double d, unsigned threadCount) {
+    size_t numNodes = wordCount();
     if (numNodes == 0) return;
 
-    std::unordered_map<std::string, double> newPageRanks;
-    std::unordered_map<std::string, double> oldPageRanks;
+    ThreadPool pool(threadCount);
+    const size_t chunkCount = std::min<size_t>(numNodes, pool.size() == 1 ? 1 : pool.size() * 8);
+    std::vector<size_t> chunkStart(chunkCount + 1, numNodes);
+    const uint64_t totalWork = numNodes + inSources.size();
+    for (size_t c = 0, v = 0; c < chunkCount; ++c) {
+        uint64_t goal = totalWork * c / chunkCount;
+        while (v < numNodes && v + inOffsets[v] < goal) {
+            ++v;
+        }
+        chunkStart[c] = v;
+    }
 
-    for (const auto& node : nodes) {
-        oldPageRanks[node.first] = node.second.pageRank;
+    // 出度为 0 的节点不向外分配（与原实现一致，其份额直接丢弃）
+    std::vector<double> shareScale(numNodes, 0.0);
+    for (size_t u = 0; u < numNodes; ++u) {
+        if (outDegree(u) > 0) {
+            shareScale[u] = d / outDegree(u);
+        }
     }
 
-    bool converged = false;
+    std::vector<double> ranks(pageRanks.begin(), pageRanks.end());
+    std::vector<double> newRanks(numNodes);
+    std::vector<double> shares(numNodes);
+    std::vector<char> chunkChanged(chunkCount);
+    const double base = (1 - d) / numNodes;
     const double threshold = 1e-6;
-    int iterations = 0;
     const int maxIterations = 100;
+    const uint64_t* offsets = inOffsets.data();
+    const WordId* sources = inSources.data();
+
+    const std::function<void(size_t)> computeShares = [&](size_t c) {
+        for (size_t u = chunkStart[c]; u < chunkStart[c + 1]; ++u) {
+            shares[u] = ranks[u] * shareScale[u];
+        }
+    };
+    // 四路部分和打破加法依赖链，便于编译器流水化和向量化
+    const std::function<void(size_t)> gatherShares = [&](size_t c) {
+        bool changed = false;
+        for (size_t v = chunkStart[c]; v < chunkStart[c + 1]; ++v) {
+            double partial[4] = {0.0, 0.0, 0.0, 0.0};
+            uint64_t e = offsets[v];
+            const uint64_t end = offsets[v + 1];
+            for (; e + 4 <= end; e += 4) {
+                partial[0] += shares[sources[e]];
+                partial[1] += shares[sources[e + 1]];
+                partial[2] += shares[sources[e + 2]];
+                partial[3] += shares[sources[e + 3]];
+            }
+            for (; e < end; ++e) {
+                partial[0] += shares[sources[e]];
+            }
+            double sum = base + ((partial[0] + partial[1]) + (partial[2] + partial[3]));
+            newRanks[v] = sum;
+            changed |= std::abs(sum - ranks[v]) > threshold;
+        }
+        chunkChanged[c] = changed;
+    };
+
+    bool converged = false;
+    int iterations = 0;
 
     while (!converged && iterations < maxIterations) {
-        converged = true;
         iterations++;
+        pool.run(chunkCount, computeShares);
+        pool.run(chunkCount, gatherShares);
+        converged = std::none_of(chunkChanged.begin(), chunkChanged.end(), [](char c) { return c != 0; });
+        ranks.swap(newRanks);
+    }
+    pageRanks = std::move(ranks);
+    pageRankDamping = d;
+    rebuildRankIndex();
+}
 
-        newPageRanks.clear();
+// 增量 PageRank：不动点满足 x = (1-d)/N + d * M x。以旧结果为初值时，
+// 只有出边变化的节点及其后继的残差会明显偏离 0，因此只对它们精确计算残差，
+// 再用 Gauss-Southwell 方式推送（残差可正可负）。N 变化带来的常数项偏移
+// 若超过 tolerance 就无法局部修正，此时退回以旧结果为初值的全量迭代
+void Graph::appendText(const std::string& text, double d, double tolerance) {
+    size_t oldCount = wordCount();
+    bool ranked = pageRankDamping == d && oldCount > 0;
+    nodes.resize(1);
+    ingestText(text, nodes[0]);
+    FreezeDelta delta = freeze();
 
-        for (const auto& node : nodes) {
-            newPageRanks[node.first] = (1 - d) / numNodes;
-            for (const auto& neighbor : nodes) {
-                if (neighbor.second.edges.find(node.first) != neighbor.second.edges.end()) {
-                    newPageRanks[node.first] += d * oldPageRanks[neighbor.first] / neighbor.second.edges.size();
-                }
-            }
+    size_t numNodes = wordCount();
+    if (numNodes == 0) {
+        return;
+    }
+    double base = (1 - d) / numNodes;
+    if (!ranked || std::abs(base - (1 - d) / oldCount) > tolerance) {
+        calculatePageRank(d);
+        return;
+    }
+
+    double* ranks = pageRanks.mutableData();
+    for (WordId id : delta.addedWords) {
+        ranks[id] = 0.0;
+    }
+
+    std::vector<WordId> affected;
+    std::vector<char> queued(numNodes, 0);
+    auto markAffected = [&](WordId id) {
+        if (!queued[id]) {
+            queued[id] = 1;
+            affected.push_back(id);
         }
+    };
+    for (WordId u : delta.changedRows) {
+        markAffected(u);
+        for (uint64_t e = outOffsets[u]; e < outOffsets[u + 1]; ++e) {
+            markAffected(outTargets[e]);
+        }
+    }
+    for (WordId id : delta.addedWords) {
+        markAffected(id);
+    }
 
-        for (auto& node : nodes) {
-            double delta = std::abs(newPageRanks[node.first] - oldPageRanks[node.first]);
-            if (delta > threshold) {
-                converged = false;
+    std::vector<double> residual(numNodes, 0.0);
+    std::queue<WordId> active;
+    std::vector<WordId> updated;
+    for (WordId v : affected) {
+        double sum = base;
+        for (uint64_t e = inOffsets[v]; e < inOffsets[v + 1]; ++e) {
+            WordId u = inSources[e];
+            sum += d * ranks[u] / outDegree(u);
+        }
+        residual[v] = sum - ranks[v];
+        if (std::abs(residual[v]) > tolerance) {
+            active.push(v);
+        } else {
+            queued[v] = 0;
+        }
+    }
+
+    while (!active.empty()) {
+        WordId u = active.front();
+        active.pop();
+        queued[u] = 0;
+        double r = residual[u];
+        residual[u] = 0.0;
+        ranks[u] += r;
+        updated.push_back(u);
+        size_t degree = outDegree(u);
+        if (degree == 0) {
+            continue;
+        }
+        double share = d * r / degree;
+        for (uint64_t e = outOffsets[u]; e < outOffsets[u + 1]; ++e) {
+            WordId v = outTargets[e];
+            residual[v] += share;
+            if (!queued[v] && std::abs(residual[v]) > tolerance) {
+                queued[v] = 1;
+                active.push(v);
             }
-            oldPageRanks[node.first] = newPageRanks[node.first];
-            node.second.pageRank = newPageRanks[node.first];
         }
     }
+
+    pageRankDamping = d;
+    updateRankIndex(std::move(updated));
 }
 
 double Graph::calcPageRank(const std::string& word) const {
-    if (nodes.find(word) == nodes.end()) {
+    WordId id = findWord(word);
+    if (id == kNoWord) {
         return 0.0;
     }
-    return nodes.at(word).pageRank;
+    return pageRanks[id];
 }
 
-std::string Graph::randomWalk() const {
-    std::vector<std::string> allNodes;
-    for (const auto& node : nodes) {
-        allNodes.push_back(node.first);
+void Graph::rebuildRankIndex() {
+    size_t numNodes = wordCount();
+    std::vector<WordId> order(numNodes);
+    for (size_t id = 0; id < numNodes; ++id) {
+        order[id] = static_cast<WordId>(id);
     }
+    std::sort(order.begin(), order.end(), [this](WordId a, WordId b) { return higherRank(pageRanks, a, b); });
+    setRankOrder(std::move(order));
+}
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, allNodes.size() - 1);
-
-    std::string current = allNodes[dis(gen)];
-    std::ostringstream oss;
-    oss << current;
+// 只有 changed 中单词的得分变了：其余单词在 rankOrder 中的相对顺序不变，
+// 把 changed 排序后与它们归并即可，排序只涉及变化的单词
+void Graph::updateRankIndex(std::vector<WordId> changed) {
+    size_t numNodes = wordCount();
+    if (rankOrder.size() != numNodes) {
+        rebuildRankIndex();
+        return;
+    }
+    if (changed.empty()) {
+        return;
+    }
+    std::vector<char> moved(numNodes, 0);
+    for (WordId id : changed) {
+        moved[id] = 1;
+    }
+    auto higher = [this](WordId a, WordId b) { return higherRank(pageRanks, a, b); };
+    std::sort(changed.begin(), changed.end(), higher);
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
 
-    while (true) {
-        if (nodes.at(current).edges.empty()) {
-            break;
+    std::vector<WordId> order;
+    order.reserve(numNodes);
+    size_t next = 0;
+    for (WordId id : rankOrder) {
+        if (moved[id]) continue;
+        while (next < changed.size() && higher(changed[next], id)) {
+            order.push_back(changed[next++]);
         }
-        std::vector<std::string> neighbors;
-        for (const auto& edge : nodes.at(current).edges) {
-            neighbors.push_back(edge.first);
+        order.push_back(id);
+    }
+    order.insert(order.end(), changed.begin() + next, changed.end());
+    setRankOrder(std::move(order));
+}
+
+void Graph::setRankOrder(std::vector<WordId> order) {
+    size_t numNodes = order.size();
+
+    // 从低到高扫描，相同得分的一组单词共享同一个计数
+    std::vector<WordId> below(numNodes);
+    size_t lower = 0;
+    for (size_t i = numNodes; i > 0;) {
+        size_t groupEnd = i;
+        double rank = pageRanks[order[i - 1]];
+        while (i > 0 && pageRanks[order[i - 1]] == rank) {
+            below[order[--i]] = static_cast<WordId>(lower);
         }
-        current = neighbors[dis(gen) % neighbors.size()];
-        oss << " -> " << current;
+        lower += groupEnd - i;
     }
 
-    return oss.str();
+    rankOrder = std::move(order);
+    rankBelow = std::move(below);
 }
 
-std::string Graph::removePunctuation(const std::string& str) const {
-    std::string result;
-    for (char c : str) {
-        if (!std::ispunct(c)) {
-            result += c;
+std::vector<std::pair<std::string, double>> Graph::topPageRank(size_t k) const {
+    k = std::min(k, wordCount());
+    std::vector<std::pair<std::string, double>> result;
+    result.reserve(k);
+    if (rankOrder.size() == wordCount()) {
+        for (size_t i = 0; i < k; ++i) {
+            result.emplace_back(std::string(wordAt(rankOrder[i])), pageRanks[rankOrder[i]]);
         }
+        return result;
+    }
+
+    // 索引尚未建立（新建图后还没计算 PageRank）时退回 O(V log k) 的部分排序
+    std::vector<WordId> ids(wordCount());
+    for (size_t id = 0; id < ids.size(); ++id) {
+        ids[id] = static_cast<WordId>(id);
+    }
+    std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [this](WordId a, WordId b) { return higherRank(pageRanks, a, b); });
+    for (size_t i = 0; i < k; ++i) {
+        result.emplace_back(std::string(wordAt(ids[i])), pageRanks[ids[i]]);
     }
     return result;
 }
 
-void Graph::exportGraphvizCode(const std::string& outputFilePath) const {
-    std::ofstream outFile(outputFilePath);
-    if (!outFile.is_open()) {
-        std::cerr << "无法打开输出文件: " << outputFilePath << std::endl;
-        return;
+double Graph::pageRankPercentile(const std::string& word) const {
+    WordId id = findWord(word);
+    if (id == kNoWord) {
+        return -1.0;
     }
+    size_t lower = 0;
+    if (rankBelow.size() == wordCount()) {
+        lower = rankBelow[id];
+    } else {
+        for (size_t other = 0; other < wordCount(); ++other) {
+            lower += pageRanks[other] < pageRanks[id];
+        }
+    }
+    return 100.0 * lower / wordCount();
+}
 
-    outFile << "digraph G {\n";
-    outFile << "    node [shape=box, fontname=\"Arial\", fontsize=12];\n";
-    outFile << "    edge [fontname=\"Arial\", fontsize=10];\n\n";
+// Andersen-Chung-Lang 前向推送：estimate 保存已确定的得分，residual 保存尚未分配的概率质量。
+// 每次推送把 (1-d) 份额留在当前节点，其余按出边均分（与 calculatePageRank 一致，
+// 出度为 0 的节点份额丢弃）。状态只为被触及的节点建立，查询开销与邻域大小成正比
+std::vector<std::pair<std::string, double>> Graph::personalizedPageRank(const std::vector<std::string>& seeds, size_t topK,
+                                                                          double d, double epsilon) const {
+    struct PushState {
+        double estimate = 0.0;
+        double residual = 0.0;
+        bool queued = false;
+        bool seed = false;
+    };
 
-    for (const auto& node : nodes) {
-        outFile << "    " << node.first << ";\n";
+    std::vector<WordId> seedIds;
+    for (const auto& seed : seeds) {
+        WordId id = findWord(seed);
+        if (id != kNoWord) {
+            seedIds.push_back(id);
+        }
+    }
+    std::sort(seedIds.begin(), seedIds.end());
+    seedIds.erase(std::unique(seedIds.begin(), seedIds.end()), seedIds.end());
+    if (seedIds.empty() || topK == 0) {
+        return {};
     }
 
-    outFile << "\n";
+    std::unordered_map<WordId, PushState> state;
+    std::queue<WordId> active;
+    for (WordId seed : seedIds) {
+        PushState& s = state[seed];
+        s.residual = 1.0 / seedIds.size();
+        s.queued = true;
+        s.seed = true;
+        active.push(seed);
+    }
 
-    for (const auto& node : nodes) {
-        for (const auto& edge : node.second.edges) {
-            outFile << "    " << node.first << " -> " << edge.first << " [label=\"" << edge.second << "\"];\n";
+    while (!active.empty()) {
+        WordId u = active.front();
+        active.pop();
+        PushState& current = state[u];
+        current.queued = false;
+        double residual = current.residual;
+        size_t degree = outDegree(u);
+        // 种子至少推送一次，否则出度超过 1 / (epsilon * 种子数) 的种子一次也不推送，结果为空
+        if (!current.seed && residual <= epsilon * std::max<size_t>(degree, 1)) {
+            continue;
+        }
+        current.seed = false;
+        current.estimate += (1 - d) * residual;
+        current.residual = 0.0;
+        if (degree == 0) {
+            continue;
+        }
+        double share = d * residual / degree;
+        for (uint64_t e = outOffsets[u]; e < outOffsets[u + 1]; ++e) {
+            WordId v = outTargets[e];
+            PushState& next = state[v];
+            next.residual += share;
+            if (!next.queued && next.residual > epsilon * std::max<size_t>(outDegree(v), 1)) {
+                next.queued = true;
+                active.push(v);
+            }
         }
     }
 
-    outFile << "}\n";
-    outFile.close();
+    std::vector<std::pair<WordId, double>> scored;
+    scored.reserve(state.size());
+    for (const auto& [id, s] : state) {
+        if (s.estimate > 0.0) {
+            scored.emplace_back(id, s.estimate);
+        }
+    }
+    auto byScore = [](const std::pair<WordId, double>& a, const std::pair<WordId, double>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    size_t count = std::min(topK, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), byScore);
 
-    std::cout << "Graphviz代码已成功导出到文件: " << outputFilePath << std::endl;
-}
\ No newline at end of file
+    std::vector<std::pair<std::string, double>> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.emplace_back(std::string(wordAt(scored[i].first)), scored[i].second);
+    }
+    return result;
+}
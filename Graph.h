@@ -1,6 +1,7 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -8,37 +9,314 @@
 #include <vector>
 #include <queue>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <cmath>
 #include <random>
 #include <cctype>
 #include <iomanip>
+#include <limits>
+#include <thread>
+#include <span>
+#include <memory>
+#include <functional>
+
+#include "FrozenArray.h"
+#include "ShortestPath.h"
+
+class MappedFile;
+class Xoshiro256;
 
 class Graph {
 public:
+    using WordId = uint32_t;
+    static constexpr WordId kNoWord = UINT32_MAX;
+
     Graph() = default;
     ~Graph() = default;
 
-    void generateGraph(const std::string& filePath);
+    // threadCount > 1 时按行边界切分文件并行建图，0 表示使用全部硬件线程
+    void generateGraph(const std::string& filePath, unsigned threadCount = 1);
+    // 把新文本的边并入现有图，并以当前 PageRank 为初值增量刷新：
+    // 只从边发生变化的节点出发推送残差，残差不超过 tolerance 的节点不再传播。
+    // 文本中没有新单词时编号不变，CSR、别名表、分量和排名索引都只更新涉及的行，
+    // 剩余的开销是有新边时整段复制邻接数组和几次 O(V) 的线性扫描；出现新单词时需要重新编号，退回全量重建
+    void appendText(const std::string& text, double d = 0.85, double tolerance = 1e-7);
     void showDirectedGraph() const;
+    // 输出有向图时单词的排列顺序：按单词（字典序）、出度降序或 PageRank 降序，并列时按单词
+    enum class GraphOrder {
+        Word,
+        OutDegree,
+        PageRank,
+    };
+    struct GraphDumpOptions {
+        GraphOrder order = GraphOrder::Word;
+        // 最多输出的单词数（排序后的前若干个），0 表示不限
+        size_t limit = 0;
+        // 每页的单词数，0 表示不分页
+        size_t pageSize = 0;
+    };
+    // 所有行先写入一块大缓冲区再整块输出；分页时每页之后从 input 读一行，读到 q 或输入结束即停止
+    void showDirectedGraph(const GraphDumpOptions& options, std::ostream& output = std::cout,
+                           std::istream& input = std::cin) const;
     std::vector<std::string> queryBridgeWords(const std::string& word1, const std::string& word2) const;
+
+    // 批量桥接词查询的结果：第 i 对单词的桥接词编号为 bridges[offsets[i], offsets[i + 1])，按编号升序
+    struct BridgeBatch {
+        std::vector<uint64_t> offsets;
+        std::vector<WordId> bridges;
+    };
+    using WordPair = std::pair<std::string_view, std::string_view>;
+    // 每个不同的单词只解析一次，按 word1 分组复用其出边表；结果写入 result（其缓冲区可跨调用复用）。
+    // 只读访问图，不同线程可以对 pairs 的不同片段各自调用
+    void queryBridgeWordsBatch(std::span<const WordPair> pairs, BridgeBatch& result) const;
     std::string generateNewText(const std::string& inputText) const;
+    // 流式改写整篇文本：逐行处理，每行结果与 generateNewText(该行) 相同，输出保持原有行序。
+    // 输入按行边界切成大块，threadCount 个块并行改写后按顺序整块写出；0 表示使用全部硬件线程
+    void generateNewText(std::istream& input, std::ostream& output, unsigned threadCount = 1) const;
+    bool generateNewTextFile(const std::string& inputPath, const std::string& outputPath, unsigned threadCount = 1) const;
     std::string calcShortestPath(const std::string& word1, const std::string& word2) const;
-    void calculatePageRank(double d = 0.85);
+    // 一条路径的单词编号序列及其总权重
+    struct WeightedPath {
+        std::vector<WordId> words;
+        int64_t weight = 0;
+    };
+    // 从 word1 到 word2 的前 k 短无环路径（Yen 算法），按总权重升序，第一条与 calcShortestPath 相同。
+    // 权重相同的路径之间的先后取决于候选生成的顺序，只由图决定、每次相同，但不保证是编号序列的字典序。
+    // 单词不存在或不可达时返回空
+    std::vector<WeightedPath> kShortestPaths(const std::string& word1, const std::string& word2, size_t k) const;
+    // 单源最短路的结果，按单词编号索引；不可达的单词距离为 kUnreachable、前驱为 kNoWord（源点的前驱也是 kNoWord）。
+    // 并列的最短路按与 calcShortestPath 相同的规则选前驱，因此沿前驱回溯得到的路径与其一致
+    static constexpr int64_t kUnreachable = INT64_MAX;
+    struct ShortestPathTree {
+        WordId source = kNoWord;
+        std::vector<int64_t> distances;
+        std::vector<WordId> predecessors;
+    };
+    // 一次 Dijkstra 求出 word 到所有单词的距离和前驱；单词不存在时返回 source 为 kNoWord 的空结果
+    ShortestPathTree shortestPathsFrom(const std::string& word) const;
+    // 批量单源最短路：sources 中的源点分给 threadCount 个线程（0 表示全部硬件线程），每个线程复用自己的工作区和结果缓冲区。
+    // sources 中须为有效的单词编号，为空时对全部单词执行（全源最短路）。每求完一个源点调用一次 visit(源点在 sources 中的下标, 结果)，
+    // visit 会被多个线程并发调用，tree 只在回调期间有效
+    void shortestPathsFromMany(std::span<const WordId> sources,
+                               const std::function<void(size_t index, const ShortestPathTree& tree)>& visit,
+                               unsigned threadCount = 1) const;
+    // 强连通分量在每次建图后计算。分量按 Tarjan 完成顺序编号，边只会从编号大的分量指向编号不大于它的分量；
+    // 分量数不太多时还建立分量之间的传递闭包，可达性查询为 O(1)
+    size_t componentCount() const { return componentSizes.size(); }
+    // 单词所在的分量编号，单词不存在时返回 kNoWord
+    uint32_t componentOf(const std::string& word) const;
+    size_t componentSize(uint32_t component) const;
+    bool canReach(const std::string& word1, const std::string& word2) const;
+    // 最短路预处理：选出 count 个地标单词，保存每个单词与各地标之间的双向距离。
+    // 之后 calcShortestPath 用三角不等式给出的距离下界剪枝、直接拒绝不可达的查询，结果与不预处理时完全相同。
+    // 地标表随快照一起保存；图发生变化（appendText、重新建图）后自动失效。
+    // 每个出堆的单词都要计算一次 O(count) 的下界，小图上双向搜索本来就只访问很少的单词，剪枝省下的不抵这部分开销，
+    // 建议单词数达到 kLandmarkMinWords 再调用。返回实际建立的地标数（Farthest 找不到更远的单词时会少于 count）
+    enum class LandmarkSelection {
+        Farthest,  // 从度数最大的单词开始，依次选离已选地标最远的单词
+        PageRank,  // PageRank 最高的单词（尚未计算时先按默认参数计算）
+    };
+    static constexpr size_t kLandmarkMinWords = 1 << 16;
+    size_t buildLandmarks(size_t count = 8, LandmarkSelection selection = LandmarkSelection::PageRank,
+                          unsigned threadCount = 1);
+    size_t landmarkCount() const { return landmarks.size(); }
+    // threadCount 为 0 时使用全部硬件线程；结果与线程数无关，逐位相同
+    void calculatePageRank(double d = 0.85, unsigned threadCount = 1);
     double calcPageRank(const std::string& word) const;
-    std::string randomWalk() const;
+    // PageRank 最高的 k 个单词，按得分降序（得分相同按单词编号）；索引在每次计算 PageRank 后重建
+    std::vector<std::pair<std::string, double>> topPageRank(size_t k) const;
+    // PageRank 严格低于该单词的单词所占百分比，单词不存在时返回 -1
+    double pageRankPercentile(const std::string& word) const;
+    // 以 seeds 为跳转目标的个性化 PageRank，前向推送近似计算，只访问种子附近的节点。
+    // 残差低于 epsilon * 出度的节点不再推送（种子总会推送一次），epsilon 越小越精确、访问的节点越多；
+    // 与 calculatePageRank 一样按出边均分、不看边权。返回得分最高的 topK 个单词，按得分降序
+    std::vector<std::pair<std::string, double>> personalizedPageRank(const std::vector<std::string>& seeds, size_t topK,
+                                                                     double d = 0.85, double epsilon = 1e-4) const;
+    // 随机游走的转移方式：Uniform 在出边中等概率选择，Weighted 按边权成比例选择（别名表，每步 O(1)）
+    enum class WalkMode {
+        Uniform,
+        Weighted,
+    };
+    std::string randomWalk(WalkMode mode = WalkMode::Uniform) const;
+    // 游走的停止条件，可以组合；全部取默认值时只在没有出边的单词处停止
+    struct WalkPolicy {
+        WalkMode mode = WalkMode::Uniform;
+        // 最多包含的单词数，0 表示不限
+        size_t maxLength = 0;
+        // 第一次重复经过同一条边时停止，重复的那一步仍输出
+        bool stopOnRepeatedEdge = false;
+        // 每步以该概率回到起点（带重启的随机游走），输出中以 " | " 标出；只在 maxLength 大于 0 时生效
+        double restartProbability = 0.0;
+    };
+    std::string randomWalk(const WalkPolicy& policy) const;
+    // 批量随机游走：第 i 条从单词 i % wordCount() 出发，最多 maxLength 个单词，遇到没有出边的单词提前结束。
+    // 游走按固定大小分块，每块使用由 seed 经 xoshiro 跳跃派生的独立随机数流，结果只取决于 seed，与线程数无关。
+    // visit(游走序号, 单词编号序列) 会被多个线程并发调用，walk 只在回调期间有效
+    void generateWalks(size_t numWalks, size_t maxLength, uint64_t seed,
+                       const std::function<void(size_t index, std::span<const WordId> walk)>& visit,
+                       unsigned threadCount = 1, WalkMode mode = WalkMode::Uniform) const;
+    // 同上，写入文件：每行一条游走，单词编号以空格分隔，按游走序号顺序写出
+    bool generateWalksFile(const std::string& outputPath, size_t numWalks, size_t maxLength, uint64_t seed,
+                           unsigned threadCount = 1, WalkMode mode = WalkMode::Uniform) const;
+    // 导出格式：Graphviz DOT（单词一律加引号并转义）、制表符分隔的边表（带表头）、GraphML，
+    // 以及紧凑的二进制边表（头部、以换行分隔的单词表、每条边 12 字节的 源/目标/权重）
+    enum class ExportFormat {
+        Dot,
+        Tsv,
+        GraphML,
+        BinaryEdges,
+    };
+    // 按单词编号分块，由 threadCount 个线程（0 表示全部硬件线程）并行格式化，按顺序整块写出
+    bool exportGraph(const std::string& outputPath, ExportFormat format, unsigned threadCount = 1) const;
+    // 子图导出的筛选条件，可以组合：单词须满足全部单词条件，边须两端都保留且满足权重条件
+    struct SubgraphFilter {
+        // 只保留 PageRank 最高的 topN 个单词，0 表示不限；须先计算 PageRank，否则导出失败
+        size_t topN = 0;
+        // 只保留与 seeds 中某个单词相距不超过 hops 步（沿出边或入边）的单词，seeds 为空表示不限
+        std::vector<std::string> seeds;
+        size_t hops = 1;
+        // 只保留权重不低于 minWeight 的边
+        int minWeight = 0;
+        // 去掉筛选后没有任何边的单词
+        bool dropIsolated = false;
+    };
+    // 只用与单词数成正比的标记数组选出子图，不复制邻接表；格式与 exportGraph 相同，
+    // GraphML 和二进制边表中的节点按子图重新连续编号
+    bool exportSubgraph(const std::string& outputPath, ExportFormat format, const SubgraphFilter& filter,
+                        unsigned threadCount = 1) const;
     void exportGraphvizCode(const std::string& outputFilePath) const;
 
+    // 单词按字典序编号为 0..wordCount()-1，找不到时返回 kNoWord
+    size_t wordCount() const { return wordOffsets.empty() ? 0 : wordOffsets.size() - 1; }
+    WordId findWord(std::string_view word) const;
+    std::string_view wordAt(WordId id) const {
+        return std::string_view(wordPool.data() + wordOffsets[id], wordOffsets[id + 1] - wordOffsets[id]);
+    }
+
+    // 版本化、带校验和的二进制快照，包含词表、邻接表、边权和 PageRank。
+    // 加载时只做一次 mmap，各数组直接指向映射内存，不为单个单词分配内存。
+    // 加载总会顺序检查各偏移数组单调、边表编号在范围内且每行有序；verify 为 true 时
+    // 还核对入边表恰好是出边表的转置，需要 O(V) 的临时数组和 O(E) 次随机访问
+    bool saveSnapshot(const std::string& snapshotPath) const;
+    bool loadSnapshot(const std::string& snapshotPath, bool verify = false);
+    static bool isSnapshotFile(const std::string& filePath);
+
 private:
+    // 支持以 std::string_view 直接查找 std::string 键，避免构造临时字符串
+    struct WordHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view word) const { return std::hash<std::string_view>{}(word); }
+    };
+
+    template <typename T>
+    using WordMap = std::unordered_map<std::string, T, WordHash, std::equal_to<>>;
+
     struct Node {
-        std::unordered_map<std::string, int> edges;
-        double pageRank = 1.0;
+        WordMap<int> edges;
     };
 
-    std::unordered_map<std::string, Node> nodes;
+    // 建图期间的暂存表，generateGraph 结束时由 freeze() 并入下面的 CSR 数组后清空。
+    // 并行建图时按单词哈希分成若干分区，同一单词只出现在一个分区中；串行时只有一个分区
+    std::vector<WordMap<Node>> nodes;
+
+    // 冻结后的紧凑表示：单词首尾相接存放在 wordPool 中，出边和入边各用一组 CSR 数组，
+    // 每行按单词编号升序排列。从快照加载时这些数组指向 snapshot 的映射内存
+    FrozenArray<char> wordPool;
+    FrozenArray<uint64_t> wordOffsets;
+    FrozenArray<uint64_t> outOffsets;
+    FrozenArray<WordId> outTargets;
+    FrozenArray<int> outWeights;
+    FrozenArray<uint64_t> inOffsets;
+    FrozenArray<WordId> inSources;
+    FrozenArray<int> inWeights;
+    FrozenArray<double> pageRanks;
+    // 按 PageRank 降序排列的单词编号，以及每个单词之下（严格更低）的单词数
+    FrozenArray<WordId> rankOrder;
+    FrozenArray<WordId> rankBelow;
+    // 地标编号，以及按 单词 * landmarks.size() + 地标序号 存放的距离：
+    // landmarkFrom 为地标到单词的距离，landmarkTo 为单词到地标的距离，不可达为 PathWorkspace::kInfinity
+    FrozenArray<WordId> landmarks;
+    FrozenArray<int64_t> landmarkFrom;
+    FrozenArray<int64_t> landmarkTo;
+    // 每个单词所在的强连通分量、各分量的大小，以及按行存放的分量可达位图（分量过多时为空）
+    FrozenArray<uint32_t> componentOfWord;
+    FrozenArray<uint32_t> componentSizes;
+    FrozenArray<uint64_t> componentReach;
+    // 凝聚图（分量之间去重后的边，CSR），以及每个分量 kLabelWords 个可达性标签，见 rebuildComponentLabels
+    FrozenArray<uint64_t> componentEdgeOffsets;
+    FrozenArray<uint32_t> componentEdges;
+    FrozenArray<uint32_t> componentLabels;
+    static constexpr size_t kLabelWords = 5;
+    // 按出边存放的别名表，见 rebuildAliasTables
+    FrozenArray<uint32_t> aliasThreshold;
+    FrozenArray<uint32_t> aliasIndex;
+    std::shared_ptr<const MappedFile> snapshot;
+    // 最近一次计算 PageRank 使用的阻尼系数；为 0 表示 pageRanks 与当前图不对应
+    double pageRankDamping = 0.0;
+
+    size_t outDegree(WordId id) const { return outOffsets[id + 1] - outOffsets[id]; }
 
-    void addEdge(const std::string& from, const std::string& to);
-    std::string removePunctuation(const std::string& str) const;
+    static void ingestText(std::string_view text, WordMap<Node>& target);
+    static void addEdge(WordMap<Node>& target, std::string_view from, std::string_view to);
+    static void mergeNodes(WordMap<Node>& target, std::string_view word, Node&& node);
+    void ingestParallel(std::string_view text, unsigned threadCount);
+    // freeze() 返回本次合并中出边集合有变化的节点和新加入的单词（均为新编号）
+    struct FreezeDelta {
+        std::vector<WordId> changedRows;
+        std::vector<WordId> addedWords;
+    };
+    FreezeDelta freeze(unsigned threadCount = 1);
+    FreezeDelta mergeStagedEdges();
+    void rewriteTokens(std::string_view text, std::string& out, std::string& scratch) const;
+    void rewriteLines(std::string_view text, std::string& out) const;
+    void rebuildRankIndex();
+    void updateRankIndex(std::vector<WordId> changed);
+    void setRankOrder(std::vector<WordId> order);
+    void rebuildComponents();
+    void rebuildComponentLabels();
+    void rebuildAliasTables(unsigned threadCount = 1);
+    void updateAliasTables(const std::vector<WordId>& rows, const FrozenArray<uint64_t>* oldOffsets);
+    static constexpr uint64_t kNoEdge = UINT64_MAX;
+    uint64_t walkEdge(WordId current, WalkMode mode, Xoshiro256& rng) const;
+    WordId walkStep(WordId current, WalkMode mode, Xoshiro256& rng) const;
+    // 导出的范围：words 为升序的单词编号，position 为单词在 words 中的下标（不导出时为 kNoWord），
+    // 二者为空指针时导出全图；边还须权重不低于 minWeight
+    struct ExportView {
+        const std::vector<WordId>* words = nullptr;
+        const std::vector<WordId>* position = nullptr;
+        int minWeight = 0;
+    };
+    bool writeExport(const std::string& outputPath, ExportFormat format, const ExportView& view,
+                     unsigned threadCount) const;
+    std::vector<Xoshiro256> walkStreams(size_t numWalks, uint64_t seed) const;
+    void runWalkBlock(size_t block, size_t numWalks, size_t maxLength, WalkMode mode, Xoshiro256& rng,
+                      std::vector<WordId>& walk,
+                      const std::function<void(size_t index, std::span<const WordId> walk)>& visit) const;
+    bool componentReaches(uint32_t from, uint32_t to) const;
+    // 分量 from 是否可能到达分量 to：有闭包时精确，否则按编号和两组区间标签排除，均为 O(1)
+    bool mayReach(uint32_t from, uint32_t to) const {
+        if (from < to) return false;
+        if (!componentReach.empty()) {
+            size_t rowWords = (componentSizes.size() + 63) / 64;
+            return (componentReach[from * rowWords + to / 64] >> (to % 64)) & 1;
+        }
+        const uint32_t* a = componentLabels.data() + from * kLabelWords;
+        const uint32_t* b = componentLabels.data() + to * kLabelWords;
+        return a[1] <= b[1] && b[0] <= a[0] && a[4] <= b[4] && b[3] <= a[3];
+    }
+    // to 在第一次遍历中位于 from 的 DFS 子树内，一定可达
+    bool treeReaches(uint32_t from, uint32_t to) const {
+        const uint32_t* a = componentLabels.data() + from * kLabelWords;
+        uint32_t post = componentLabels[to * kLabelWords];
+        return a[2] <= post && post <= a[0];
+    }
+    static PathWorkspace& pathWorkspace(size_t slot);
+    void runDijkstra(WordId source, WordId target, PathWorkspace& workspace, bool reverse = false) const;
+    int edgeWeight(WordId from, WordId to) const;
+    void fillPathTree(WordId source, const PathWorkspace& workspace, ShortestPathTree& tree) const;
+    bool runBidirectional(WordId source, WordId target, PathWorkspace& forward, PathWorkspace& backward) const;
+    int64_t landmarkBound(WordId from, WordId to) const;
 };
 
 #endif // GRAPH_H
@@ -0,0 +1,313 @@
+#include "Graph.h"
+#include "ThreadPool.h"
+
+#include <charconv>
+#include <cstring>
+
+// 导出：按单词编号把图切成若干块，每块的节点或边由线程池并行格式化到各自的缓冲区，
+// 再按块的顺序整块写出。输出与线程数无关，逐字节相同
+namespace {
+
+// 每块大约包含的“单词数 + 边数”
+const uint64_t kExportChunkCost = 1 << 14;
+
+const char kBinaryMagic[4] = {'W', 'G', 'E', 'L'};
+const uint32_t kBinaryVersion = 1;
+
+// 二进制边表（本机字节序）：BinaryHeader | 单词表（每个单词后接 '\n'） | BinaryEdge[edgeCount]
+struct BinaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t wordCount;
+    uint64_t edgeCount;
+    uint64_t wordBytes;
+};
+
+struct BinaryEdge {
+    uint32_t source;
+    uint32_t target;
+    int32_t weight;
+};
+
+void appendNumber(std::string& out, int64_t value) {
+    char digits[24];
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+// DOT 的双引号字符串：只需转义 '"' 和 '\'
+void appendDotQuoted(std::string& out, std::string_view word) {
+    out += '"';
+    for (char c : word) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+void appendXmlEscaped(std::string& out, std::string_view word) {
+    for (char c : word) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            case '\'': out += "&apos;"; break;
+            default: out += c;
+        }
+    }
+}
+
+} // namespace
+
+bool Graph::exportGraph(const std::string& outputPath, ExportFormat format, unsigned threadCount) const {
+    return writeExport(outputPath, format, ExportView{}, threadCount);
+}
+
+// 依次按各项条件筛选单词，只用与单词数成正比的标记数组，不复制邻接表
+bool Graph::exportSubgraph(const std::string& outputPath, ExportFormat format, const SubgraphFilter& filter,
+                           unsigned threadCount) const {
+    const size_t numNodes = wordCount();
+    std::vector<char> keep(numNodes, 1);
+
+    if (filter.topN > 0 && filter.topN < numNodes) {
+        // 直接取排名索引的前 topN 项；pageRanks 与当前图不对应时排名没有意义
+        if (pageRankDamping == 0.0 || rankOrder.size() != numNodes) {
+            std::cerr << "尚未计算PageRank，无法按排名筛选子图" << std::endl;
+            return false;
+        }
+        std::fill(keep.begin(), keep.end(), 0);
+        for (size_t i = 0; i < filter.topN; ++i) {
+            keep[rankOrder[i]] = 1;
+        }
+    }
+
+    if (!filter.seeds.empty()) {
+        // 从种子出发沿出边和入边逐层扩展 hops 层
+        std::vector<uint32_t> depth(numNodes, UINT32_MAX);
+        std::vector<WordId> frontier, next;
+        for (const std::string& seed : filter.seeds) {
+            WordId id = findWord(seed);
+            if (id != kNoWord && depth[id] != 0) {
+                depth[id] = 0;
+                frontier.push_back(id);
+            }
+        }
+        for (size_t level = 1; level <= filter.hops && !frontier.empty(); ++level) {
+            next.clear();
+            auto visit = [&](WordId w) {
+                if (depth[w] == UINT32_MAX) {
+                    depth[w] = static_cast<uint32_t>(level);
+                    next.push_back(w);
+                }
+            };
+            for (WordId u : frontier) {
+                for (uint64_t e = outOffsets[u]; e < outOffsets[u + 1]; ++e) {
+                    visit(outTargets[e]);
+                }
+                for (uint64_t e = inOffsets[u]; e < inOffsets[u + 1]; ++e) {
+                    visit(inSources[e]);
+                }
+            }
+            frontier.swap(next);
+        }
+        for (size_t u = 0; u < numNodes; ++u) {
+            keep[u] = keep[u] && depth[u] != UINT32_MAX;
+        }
+    }
+
+    if (filter.dropIsolated) {
+        // 只看两端都保留、且权重达到阈值的边
+        std::vector<char> connected(numNodes, 0);
+        for (size_t u = 0; u < numNodes; ++u) {
+            if (!keep[u]) continue;
+            for (uint64_t e = outOffsets[u]; e < outOffsets[u + 1]; ++e) {
+                if (keep[outTargets[e]] && outWeights[e] >= filter.minWeight) {
+                    connected[u] = 1;
+                    connected[outTargets[e]] = 1;
+                }
+            }
+        }
+        for (size_t u = 0; u < numNodes; ++u) {
+            keep[u] = keep[u] && connected[u];
+        }
+    }
+
+    std::vector<WordId> words;
+    std::vector<WordId> position(numNodes, kNoWord);
+    for (size_t u = 0; u < numNodes; ++u) {
+        if (keep[u]) {
+            position[u] = static_cast<WordId>(words.size());
+            words.push_back(static_cast<WordId>(u));
+        }
+    }
+    ExportView view;
+    view.words = &words;
+    view.position = &position;
+    view.minWeight = filter.minWeight;
+    return writeExport(outputPath, format, view, threadCount);
+}
+
+bool Graph::writeExport(const std::string& outputPath, ExportFormat format, const ExportView& view,
+                        unsigned threadCount) const {
+    std::ofstream outFile(outputPath, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "无法打开输出文件: " << outputPath << std::endl;
+        return false;
+    }
+
+    // 第 i 个导出的单词及其在导出结果中的编号；全图导出时二者都是单词编号本身
+    const size_t count = view.words != nullptr ? view.words->size() : wordCount();
+    auto wordOf = [&](size_t i) { return view.words != nullptr ? (*view.words)[i] : static_cast<WordId>(i); };
+    auto indexOf = [&](WordId word) { return view.position != nullptr ? (*view.position)[word] : word; };
+    auto keepEdge = [&](uint64_t e) { return outWeights[e] >= view.minWeight && indexOf(outTargets[e]) != kNoWord; };
+
+    // 块边界 [chunks[i], chunks[i + 1]) 为导出单词的下标区间
+    std::vector<size_t> chunks = {0};
+    uint64_t cost = 0;
+    for (size_t i = 0; i < count; ++i) {
+        cost += 1 + outDegree(wordOf(i));
+        if (cost >= kExportChunkCost) {
+            chunks.push_back(i + 1);
+            cost = 0;
+        }
+    }
+    if (chunks.back() != count) {
+        chunks.push_back(count);
+    }
+
+    ThreadPool pool(threadCount);
+    std::vector<std::string> outputs(pool.size());
+    uint64_t written = 0;
+    auto writeChunks = [&](const std::function<void(size_t first, size_t last, std::string& out)>& formatChunk) {
+        const size_t chunkCount = chunks.size() - 1;
+        for (size_t first = 0; first < chunkCount; first += outputs.size()) {
+            size_t filled = std::min(outputs.size(), chunkCount - first);
+            pool.run(filled, [&](size_t i) {
+                outputs[i].clear();
+                formatChunk(chunks[first + i], chunks[first + i + 1], outputs[i]);
+            });
+            for (size_t i = 0; i < filled; ++i) {
+                outFile.write(outputs[i].data(), static_cast<std::streamsize>(outputs[i].size()));
+                written += outputs[i].size();
+            }
+        }
+    };
+    // 逐个导出单词调用 visit(单词)
+    auto forWords = [&](const std::function<void(WordId u, std::string& out)>& visit) {
+        writeChunks([&](size_t first, size_t last, std::string& out) {
+            for (size_t i = first; i < last; ++i) {
+                visit(wordOf(i), out);
+            }
+        });
+    };
+    // 逐条导出的边调用 visit(起点, 边编号)
+    auto forEdges = [&](const std::function<void(WordId u, uint64_t e, std::string& out)>& visit) {
+        writeChunks([&](size_t first, size_t last, std::string& out) {
+            for (size_t i = first; i < last; ++i) {
+                WordId u = wordOf(i);
+                for (uint64_t e = outOffsets[u]; e < outOffsets[u + 1]; ++e) {
+                    if (keepEdge(e)) {
+                        visit(u, e, out);
+                    }
+                }
+            }
+        });
+    };
+    auto writeString = [&](std::string_view text) {
+        outFile.write(text.data(), static_cast<std::streamsize>(text.size()));
+    };
+
+    switch (format) {
+        case ExportFormat::Dot:
+            writeString("digraph G {\n"
+                        "    node [shape=box, fontname=\"Arial\", fontsize=12];\n"
+                        "    edge [fontname=\"Arial\", fontsize=10];\n\n");
+            forWords([&](WordId u, std::string& out) {
+                out += "    ";
+                appendDotQuoted(out, wordAt(u));
+                out += ";\n";
+            });
+            writeString("\n");
+            forEdges([&](WordId u, uint64_t e, std::string& out) {
+                out += "    ";
+                appendDotQuoted(out, wordAt(u));
+                out += " -> ";
+                appendDotQuoted(out, wordAt(outTargets[e]));
+                out += " [label=\"";
+                appendNumber(out, outWeights[e]);
+                out += "\"];\n";
+            });
+            writeString("}\n");
+            break;
+
+        case ExportFormat::Tsv:
+            // 单词中不含空白字符，无需转义
+            writeString("source\ttarget\tweight\n");
+            forEdges([&](WordId u, uint64_t e, std::string& out) {
+                out += wordAt(u);
+                out += '\t';
+                out += wordAt(outTargets[e]);
+                out += '\t';
+                appendNumber(out, outWeights[e]);
+                out += '\n';
+            });
+            break;
+
+        case ExportFormat::GraphML:
+            // 节点 id 用导出编号，单词本身放在 data 中并做 XML 转义
+            writeString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+                        "  <key id=\"word\" for=\"node\" attr.name=\"word\" attr.type=\"string\"/>\n"
+                        "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"int\"/>\n"
+                        "  <graph id=\"G\" edgedefault=\"directed\">\n");
+            forWords([&](WordId u, std::string& out) {
+                out += "    <node id=\"n";
+                appendNumber(out, indexOf(u));
+                out += "\"><data key=\"word\">";
+                appendXmlEscaped(out, wordAt(u));
+                out += "</data></node>\n";
+            });
+            forEdges([&](WordId u, uint64_t e, std::string& out) {
+                out += "    <edge source=\"n";
+                appendNumber(out, indexOf(u));
+                out += "\" target=\"n";
+                appendNumber(out, indexOf(outTargets[e]));
+                out += "\"><data key=\"weight\">";
+                appendNumber(out, outWeights[e]);
+                out += "</data></edge>\n";
+            });
+            writeString("  </graph>\n</graphml>\n");
+            break;
+
+        case ExportFormat::BinaryEdges: {
+            // 边数和单词表长度写完后才知道，最后回到开头补写头部
+            BinaryHeader header{};
+            std::memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+            header.version = kBinaryVersion;
+            header.wordCount = count;
+            outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            forWords([&](WordId u, std::string& out) {
+                out += wordAt(u);
+                out += '\n';
+            });
+            header.wordBytes = written;
+            forEdges([&](WordId u, uint64_t e, std::string& out) {
+                BinaryEdge edge{indexOf(u), indexOf(outTargets[e]), outWeights[e]};
+                out.append(reinterpret_cast<const char*>(&edge), sizeof(edge));
+            });
+            header.edgeCount = (written - header.wordBytes) / sizeof(BinaryEdge);
+            outFile.seekp(0);
+            outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            break;
+        }
+    }
+    return outFile.good();
+}
+
+void Graph::exportGraphvizCode(const std::string& outputFilePath) const {
+    if (exportGraph(outputFilePath, ExportFormat::Dot)) {
+        std::cout << "Graphviz代码已成功导出到文件: " << outputFilePath << std::endl;
+    }
+}
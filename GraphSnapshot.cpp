@@ -0,0 +1,431 @@
+#include "Graph.h"
+#include "MappedFile.h"
+
+#include <cstring>
+
+// 快照文件布局（本机字节序，所有段按 8 字节对齐）：
+//   SnapshotHeader | SnapshotSection[sectionCount] | 各段数据
+// 校验和由段表和每个段的数据依次合并得到；加载时只建立一次映射，各数组直接指向段数据。
+namespace {
+
+const char kSnapshotMagic[8] = {'L', 'A', 'B', 'G', 'R', 'A', 'P', 'H'};
+// 版本 2 增加了 kPageRankDamping 段；版本 1 的快照仍可加载，只是 PageRank 视为与阻尼系数无关，追加文本时全量重算
+const uint32_t kSnapshotVersion = 2;
+const uint32_t kOldestSnapshotVersion = 1;
+const uint32_t kByteOrderMark = 0x01020304;
+
+enum SectionId : uint32_t {
+    kWordOffsets = 1,
+    kWordPool,
+    kOutOffsets,
+    kOutTargets,
+    kOutWeights,
+    kInOffsets,
+    kInSources,
+    kInWeights,
+    kPageRanks,
+    kRankOrder,
+    kRankBelow,
+    kLandmarks,
+    kLandmarkFrom,
+    kLandmarkTo,
+    kComponentOf,
+    kComponentSizes,
+    kComponentReach,
+    kAliasThreshold,
+    kAliasIndex,
+    kPageRankDamping,
+    kComponentEdgeOffsets,
+    kComponentEdges,
+    kComponentLabels,
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t wordCount;
+    uint64_t edgeCount;
+    uint64_t sectionCount;
+    uint64_t checksum;
+};
+
+struct SnapshotSection {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct SectionSource {
+    uint32_t id;
+    uint32_t elementSize;
+    const void* data;
+    uint64_t count;
+};
+
+uint64_t alignUp(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+// 四路交错的 64 位乘法散列，打破依赖链后校验速度接近内存带宽
+uint64_t snapshotChecksum(const char* data, size_t length) {
+    const uint64_t prime = 0x9E3779B97F4A7C15ull;
+    uint64_t lanes[4] = {1, 2, 3, 4};
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        for (int k = 0; k < 4; ++k) {
+            uint64_t word;
+            std::memcpy(&word, data + i + 8 * k, sizeof(word));
+            lanes[k] = (lanes[k] ^ word) * prime;
+            lanes[k] ^= lanes[k] >> 29;
+        }
+    }
+    uint64_t hash = length;
+    for (; i < length; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    for (uint64_t lane : lanes) {
+        hash = (hash ^ lane) * prime;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+uint64_t combineChecksum(uint64_t seed, uint64_t value) {
+    return (seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2))) * 0xFF51AFD7ED558CCDull;
+}
+
+} // namespace
+
+bool Graph::saveSnapshot(const std::string& snapshotPath) const {
+    // 空图没有偏移数组，写出只含一个 0 的数组，保证加载后 wordCount() 为 0
+    static const uint64_t kEmptyOffsets[1] = {0};
+    auto offsetsOf = [](const FrozenArray<uint64_t>& offsets) {
+        return offsets.empty() ? std::make_pair(kEmptyOffsets, uint64_t(1)) : std::make_pair(offsets.data(), uint64_t(offsets.size()));
+    };
+    auto [wordOffsetData, wordOffsetCount] = offsetsOf(wordOffsets);
+    auto [outOffsetData, outOffsetCount] = offsetsOf(outOffsets);
+    auto [inOffsetData, inOffsetCount] = offsetsOf(inOffsets);
+
+    const SectionSource sources[] = {
+        {kWordOffsets, sizeof(uint64_t), wordOffsetData, wordOffsetCount},
+        {kWordPool, sizeof(char), wordPool.data(), wordPool.size()},
+        {kOutOffsets, sizeof(uint64_t), outOffsetData, outOffsetCount},
+        {kOutTargets, sizeof(WordId), outTargets.data(), outTargets.size()},
+        {kOutWeights, sizeof(int), outWeights.data(), outWeights.size()},
+        {kInOffsets, sizeof(uint64_t), inOffsetData, inOffsetCount},
+        {kInSources, sizeof(WordId), inSources.data(), inSources.size()},
+        {kInWeights, sizeof(int), inWeights.data(), inWeights.size()},
+        {kPageRanks, sizeof(double), pageRanks.data(), pageRanks.size()},
+        {kRankOrder, sizeof(WordId), rankOrder.data(), rankOrder.size()},
+        {kRankBelow, sizeof(WordId), rankBelow.data(), rankBelow.size()},
+        {kLandmarks, sizeof(WordId), landmarks.data(), landmarks.size()},
+        {kLandmarkFrom, sizeof(int64_t), landmarkFrom.data(), landmarkFrom.size()},
+        {kLandmarkTo, sizeof(int64_t), landmarkTo.data(), landmarkTo.size()},
+        {kComponentOf, sizeof(uint32_t), componentOfWord.data(), componentOfWord.size()},
+        {kComponentSizes, sizeof(uint32_t), componentSizes.data(), componentSizes.size()},
+        {kComponentReach, sizeof(uint64_t), componentReach.data(), componentReach.size()},
+        {kAliasThreshold, sizeof(uint32_t), aliasThreshold.data(), aliasThreshold.size()},
+        {kAliasIndex, sizeof(uint32_t), aliasIndex.data(), aliasIndex.size()},
+        {kComponentEdgeOffsets, sizeof(uint64_t), componentEdgeOffsets.data(), componentEdgeOffsets.size()},
+        {kComponentEdges, sizeof(uint32_t), componentEdges.data(), componentEdges.size()},
+        {kComponentLabels, sizeof(uint32_t), componentLabels.data(), componentLabels.size()},
+        {kPageRankDamping, sizeof(double), &pageRankDamping, 1},
+    };
+    const size_t sectionCount = sizeof(sources) / sizeof(sources[0]);
+
+    std::vector<SnapshotSection> sections(sectionCount);
+    uint64_t offset = alignUp(sizeof(SnapshotHeader) + sectionCount * sizeof(SnapshotSection));
+    for (size_t i = 0; i < sectionCount; ++i) {
+        sections[i] = {sources[i].id, sources[i].elementSize, offset, sources[i].count};
+        offset = alignUp(offset + sources[i].count * sources[i].elementSize);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.byteOrder = kByteOrderMark;
+    header.wordCount = wordCount();
+    header.edgeCount = outTargets.size();
+    header.sectionCount = sectionCount;
+    header.checksum = snapshotChecksum(reinterpret_cast<const char*>(sections.data()), sectionCount * sizeof(SnapshotSection));
+    for (size_t i = 0; i < sectionCount; ++i) {
+        header.checksum = combineChecksum(header.checksum,
+            snapshotChecksum(static_cast<const char*>(sources[i].data), sources[i].count * sources[i].elementSize));
+    }
+
+    std::ofstream outFile(snapshotPath, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "无法打开快照文件: " << snapshotPath << std::endl;
+        return false;
+    }
+    const char padding[8] = {};
+    uint64_t written = 0;
+    auto write = [&](const void* data, uint64_t size) {
+        outFile.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+    write(&header, sizeof(header));
+    write(sections.data(), sectionCount * sizeof(SnapshotSection));
+    for (size_t i = 0; i < sectionCount; ++i) {
+        write(padding, sections[i].offset - written);
+        write(sources[i].data, sources[i].count * sources[i].elementSize);
+    }
+    write(padding, offset - written);
+    if (!outFile) {
+        std::cerr << "写入快照文件失败: " << snapshotPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Graph::isSnapshotFile(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    char magic[sizeof(kSnapshotMagic)] = {};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, kSnapshotMagic, sizeof(magic)) == 0;
+}
+
+bool Graph::loadSnapshot(const std::string& snapshotPath, bool verify) {
+    auto file = std::make_shared<MappedFile>(snapshotPath);
+    if (!file->isOpen()) {
+        std::cerr << "无法打开快照文件: " << snapshotPath << std::endl;
+        return false;
+    }
+
+    const char* base = file->data();
+    SnapshotHeader header;
+    if (file->size() < sizeof(header)) {
+        std::cerr << "快照文件已损坏: " << snapshotPath << std::endl;
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 || header.byteOrder != kByteOrderMark) {
+        std::cerr << "不是有效的快照文件: " << snapshotPath << std::endl;
+        return false;
+    }
+    if (header.version < kOldestSnapshotVersion || header.version > kSnapshotVersion) {
+        std::cerr << "不支持的快照版本 " << header.version << ": " << snapshotPath << std::endl;
+        return false;
+    }
+    if (header.sectionCount > (file->size() - sizeof(header)) / sizeof(SnapshotSection)) {
+        std::cerr << "快照文件已损坏: " << snapshotPath << std::endl;
+        return false;
+    }
+
+    const auto* sections = reinterpret_cast<const SnapshotSection*>(base + sizeof(header));
+    auto findSection = [&](uint32_t id, uint32_t elementSize, uint64_t expectedCount) -> const SnapshotSection* {
+        for (uint64_t i = 0; i < header.sectionCount; ++i) {
+            const SnapshotSection& section = sections[i];
+            if (section.id != id) {
+                continue;
+            }
+            bool valid = section.elementSize == elementSize && section.offset % 8 == 0 &&
+                         section.offset <= file->size() &&
+                         section.count <= (file->size() - section.offset) / elementSize &&
+                         (expectedCount == UINT64_MAX || section.count == expectedCount);
+            return valid ? &section : nullptr;
+        }
+        return nullptr;
+    };
+
+    const uint64_t words = header.wordCount;
+    const uint64_t edges = header.edgeCount;
+    const SnapshotSection* layout[] = {
+        findSection(kWordOffsets, sizeof(uint64_t), words + 1),
+        findSection(kWordPool, sizeof(char), UINT64_MAX),
+        findSection(kOutOffsets, sizeof(uint64_t), words + 1),
+        findSection(kOutTargets, sizeof(WordId), edges),
+        findSection(kOutWeights, sizeof(int), edges),
+        findSection(kInOffsets, sizeof(uint64_t), words + 1),
+        findSection(kInSources, sizeof(WordId), edges),
+        findSection(kInWeights, sizeof(int), edges),
+        findSection(kPageRanks, sizeof(double), words),
+    };
+    for (const SnapshotSection* section : layout) {
+        if (section == nullptr) {
+            std::cerr << "快照文件缺少或包含无效的数据段: " << snapshotPath << std::endl;
+            return false;
+        }
+    }
+
+    // 可选段：缺失时在加载后重新计算
+    const SnapshotSection* order = findSection(kRankOrder, sizeof(WordId), words);
+    const SnapshotSection* below = findSection(kRankBelow, sizeof(WordId), words);
+    const SnapshotSection* marks = findSection(kLandmarks, sizeof(WordId), UINT64_MAX);
+    const SnapshotSection* marksFrom = nullptr;
+    const SnapshotSection* marksTo = nullptr;
+    if (marks != nullptr && marks->count <= words) {
+        marksFrom = findSection(kLandmarkFrom, sizeof(int64_t), marks->count * words);
+        marksTo = findSection(kLandmarkTo, sizeof(int64_t), marks->count * words);
+    }
+    const SnapshotSection* componentOf = findSection(kComponentOf, sizeof(uint32_t), words);
+    const SnapshotSection* sizes = findSection(kComponentSizes, sizeof(uint32_t), UINT64_MAX);
+    const SnapshotSection* reach = nullptr;
+    const SnapshotSection* dagOffsets = nullptr;
+    const SnapshotSection* dagEdges = nullptr;
+    const SnapshotSection* labels = nullptr;
+    if (sizes != nullptr) {
+        uint64_t rowWords = (sizes->count + 63) / 64;
+        reach = findSection(kComponentReach, sizeof(uint64_t), UINT64_MAX);
+        if (reach != nullptr && reach->count != 0 && reach->count != sizes->count * rowWords) {
+            reach = nullptr;
+        }
+        dagOffsets = findSection(kComponentEdgeOffsets, sizeof(uint64_t), sizes->count + 1);
+        dagEdges = findSection(kComponentEdges, sizeof(uint32_t), UINT64_MAX);
+        labels = findSection(kComponentLabels, sizeof(uint32_t), sizes->count * kLabelWords);
+    }
+    const SnapshotSection* threshold = findSection(kAliasThreshold, sizeof(uint32_t), edges);
+    const SnapshotSection* alias = findSection(kAliasIndex, sizeof(uint32_t), edges);
+    const SnapshotSection* damping = findSection(kPageRankDamping, sizeof(double), 1);
+
+    // 校验和只能发现意外损坏。偏移和编号在这里逐项检查，之后的查询直接按它们下标访问，不再做边界检查
+    auto at = [&](const SnapshotSection* section) { return base + section->offset; };
+    auto offsetsOf = [&](const SnapshotSection* section) { return reinterpret_cast<const uint64_t*>(at(section)); };
+    auto idsOf = [&](const SnapshotSection* section) { return reinterpret_cast<const uint32_t*>(at(section)); };
+    auto offsetsValid = [&](const SnapshotSection* section, uint64_t total) {
+        const uint64_t* offsets = offsetsOf(section);
+        for (uint64_t i = 0; i < words; ++i) {
+            if (offsets[i] > offsets[i + 1]) return false;
+        }
+        return offsets[0] == 0 && offsets[words] == total;
+    };
+    // 每行的编号严格递增（即有序且没有重复的边），且都是有效的单词编号
+    auto rowsValid = [&](const SnapshotSection* offsetSection, const SnapshotSection* idSection) {
+        const uint64_t* offsets = offsetsOf(offsetSection);
+        const uint32_t* ids = idsOf(idSection);
+        for (uint64_t u = 0; u < words; ++u) {
+            for (uint64_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                if (ids[e] >= words || (e > offsets[u] && ids[e] <= ids[e - 1])) return false;
+            }
+        }
+        return true;
+    };
+    auto idsBelow = [&](const SnapshotSection* section, uint64_t bound) {
+        return section == nullptr ||
+               std::all_of(idsOf(section), idsOf(section) + section->count, [bound](uint32_t id) { return id < bound; });
+    };
+    // 入边表须恰好是出边表的转置：按源点顺序遍历出边，依次对上每个目标入边行中的下一项。
+    // 按目标随机访问 O(E) 次，只在 verify 时检查；默认只检查入边行的编号范围和顺序
+    auto transposed = [&]() {
+        const uint64_t* outRows = offsetsOf(layout[2]);
+        const uint64_t* inRows = offsetsOf(layout[5]);
+        const uint32_t* targets = idsOf(layout[3]);
+        const uint32_t* sources = idsOf(layout[6]);
+        const int* weights = reinterpret_cast<const int*>(at(layout[4]));
+        const int* sourceWeights = reinterpret_cast<const int*>(at(layout[7]));
+        std::vector<uint64_t> cursor(inRows, inRows + words);
+        for (uint64_t u = 0; u < words; ++u) {
+            for (uint64_t e = outRows[u]; e < outRows[u + 1]; ++e) {
+                uint64_t slot = cursor[targets[e]]++;
+                if (slot >= inRows[targets[e] + 1] || sources[slot] != u || sourceWeights[slot] != weights[e]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    bool consistent = offsetsValid(layout[0], layout[1]->count) && offsetsValid(layout[2], edges) &&
+                      offsetsValid(layout[5], edges) && rowsValid(layout[2], layout[3]) &&
+                      rowsValid(layout[5], layout[6]) && (!verify || transposed()) &&
+                      idsBelow(order, words) && idsBelow(marks, words) &&
+                      (sizes == nullptr || idsBelow(componentOf, sizes->count));
+    // 凝聚图的边只能从编号大的分量指向编号小的分量，搜索依赖这一点才不会走回头路
+    if (consistent && dagOffsets != nullptr && dagEdges != nullptr) {
+        const uint64_t* offsets = offsetsOf(dagOffsets);
+        const uint32_t* targets = idsOf(dagEdges);
+        consistent = offsets[0] == 0 && offsets[sizes->count] == dagEdges->count;
+        for (uint64_t c = 0; c < sizes->count && consistent; ++c) {
+            consistent = offsets[c] <= offsets[c + 1] && offsets[c + 1] <= dagEdges->count;
+            for (uint64_t e = offsets[c]; e < offsets[c + 1] && consistent; ++e) {
+                consistent = targets[e] < c;
+            }
+        }
+    }
+    // 别名只能指向本行的某一列
+    if (consistent && alias != nullptr) {
+        const uint64_t* offsets = offsetsOf(layout[2]);
+        const uint32_t* columns = idsOf(alias);
+        for (uint64_t u = 0; u < words && consistent; ++u) {
+            for (uint64_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                consistent = consistent && columns[e] < offsets[u + 1] - offsets[u];
+            }
+        }
+    }
+    if (!consistent) {
+        std::cerr << "快照文件数据不一致: " << snapshotPath << std::endl;
+        return false;
+    }
+
+    uint64_t checksum = snapshotChecksum(reinterpret_cast<const char*>(sections), header.sectionCount * sizeof(SnapshotSection));
+    for (uint64_t i = 0; i < header.sectionCount; ++i) {
+        const SnapshotSection& section = sections[i];
+        if (section.elementSize == 0 || section.offset > file->size() ||
+            section.count > (file->size() - section.offset) / section.elementSize) {
+            std::cerr << "快照文件已损坏: " << snapshotPath << std::endl;
+            return false;
+        }
+        checksum = combineChecksum(checksum, snapshotChecksum(base + section.offset, section.count * section.elementSize));
+    }
+    if (checksum != header.checksum) {
+        std::cerr << "快照文件校验失败: " << snapshotPath << std::endl;
+        return false;
+    }
+
+    std::vector<WordMap<Node>>().swap(nodes);
+    wordOffsets.attach(reinterpret_cast<const uint64_t*>(at(layout[0])), layout[0]->count);
+    wordPool.attach(at(layout[1]), layout[1]->count);
+    outOffsets.attach(reinterpret_cast<const uint64_t*>(at(layout[2])), layout[2]->count);
+    outTargets.attach(reinterpret_cast<const WordId*>(at(layout[3])), layout[3]->count);
+    outWeights.attach(reinterpret_cast<const int*>(at(layout[4])), layout[4]->count);
+    inOffsets.attach(reinterpret_cast<const uint64_t*>(at(layout[5])), layout[5]->count);
+    inSources.attach(reinterpret_cast<const WordId*>(at(layout[6])), layout[6]->count);
+    inWeights.attach(reinterpret_cast<const int*>(at(layout[7])), layout[7]->count);
+    pageRanks.attach(reinterpret_cast<const double*>(at(layout[8])), layout[8]->count);
+
+    // 阻尼系数与 pageRanks 一起保存，加载后 appendText 可以继续增量刷新
+    pageRankDamping = 0.0;
+    if (damping != nullptr) {
+        std::memcpy(&pageRankDamping, at(damping), sizeof(pageRankDamping));
+    }
+    snapshot = std::move(file);
+
+    // 排名索引是可选段，旧快照或索引为空时重新建立
+    if (order != nullptr && below != nullptr) {
+        rankOrder.attach(reinterpret_cast<const WordId*>(at(order)), order->count);
+        rankBelow.attach(reinterpret_cast<const WordId*>(at(below)), below->count);
+    } else {
+        rebuildRankIndex();
+    }
+
+    // 地标表同样可选；缺失时不使用地标，查询退回双向 Dijkstra
+    if (marksFrom != nullptr && marksTo != nullptr) {
+        landmarks.attach(reinterpret_cast<const WordId*>(at(marks)), marks->count);
+        landmarkFrom.attach(reinterpret_cast<const int64_t*>(at(marksFrom)), marksFrom->count);
+        landmarkTo.attach(reinterpret_cast<const int64_t*>(at(marksTo)), marksTo->count);
+    } else {
+        landmarks = std::vector<WordId>();
+        landmarkFrom = std::vector<int64_t>();
+        landmarkTo = std::vector<int64_t>();
+    }
+
+    // 强连通分量同样可选，缺失时重新计算
+    if (componentOf != nullptr && reach != nullptr && dagOffsets != nullptr && dagEdges != nullptr && labels != nullptr) {
+        componentOfWord.attach(reinterpret_cast<const uint32_t*>(at(componentOf)), componentOf->count);
+        componentSizes.attach(reinterpret_cast<const uint32_t*>(at(sizes)), sizes->count);
+        componentReach.attach(reinterpret_cast<const uint64_t*>(at(reach)), reach->count);
+        componentEdgeOffsets.attach(reinterpret_cast<const uint64_t*>(at(dagOffsets)), dagOffsets->count);
+        componentEdges.attach(reinterpret_cast<const uint32_t*>(at(dagEdges)), dagEdges->count);
+        componentLabels.attach(reinterpret_cast<const uint32_t*>(at(labels)), labels->count);
+    } else {
+        rebuildComponents();
+    }
+    if (threshold != nullptr && alias != nullptr) {
+        aliasThreshold.attach(reinterpret_cast<const uint32_t*>(at(threshold)), threshold->count);
+        aliasIndex.attach(reinterpret_cast<const uint32_t*>(at(alias)), alias->count);
+    } else {
+        rebuildAliasTables();
+    }
+    return true;
+}
@@ -0,0 +1,112 @@
+#include "Graph.h"
+#include "ThreadPool.h"
+
+// ALT（A*、地标、三角不等式）：对任意地标 L，
+//   d(v, t) >= d(L, t) - d(L, v)   且   d(v, t) >= d(v, L) - d(t, L)，
+// 取地标上的最大值作为 v 到 t 的下界。runBidirectional 用它剪掉不可能在最短路上的节点，
+// 并在 O(地标数) 内拒绝不可达的查询。
+size_t Graph::buildLandmarks(size_t count, LandmarkSelection selection, unsigned threadCount) {
+    const size_t numNodes = wordCount();
+    const int64_t infinity = PathWorkspace::kInfinity;
+    landmarks = std::vector<WordId>();
+    landmarkFrom = std::vector<int64_t>();
+    landmarkTo = std::vector<int64_t>();
+    if (numNodes == 0 || count == 0) return 0;
+    count = std::min(count, numNodes);
+
+    // 每个地标两张表：沿出边求 d(L, v)，沿入边求 d(v, L)；每个线程用自己的工作区
+    ThreadPool pool(threadCount);
+    std::vector<WordId> chosen;
+    std::vector<std::vector<int64_t>> fromRows, toRows;
+    auto computeRows = [&](size_t first) {
+        fromRows.resize(chosen.size());
+        toRows.resize(chosen.size());
+        pool.run(2 * (chosen.size() - first), [&](size_t task) {
+            size_t index = first + task / 2;
+            bool reverse = task % 2 == 1;
+            PathWorkspace& workspace = pathWorkspace(0);
+            runDijkstra(chosen[index], kNoWord, workspace, reverse);
+            std::vector<int64_t>& row = reverse ? toRows[index] : fromRows[index];
+            row.resize(numNodes);
+            for (size_t v = 0; v < numNodes; ++v) {
+                row[v] = workspace.distance(static_cast<WordId>(v));
+            }
+        });
+    };
+
+    if (selection == LandmarkSelection::PageRank) {
+        if (rankOrder.size() != numNodes) {
+            calculatePageRank(0.85, threadCount);
+        }
+        chosen.assign(rankOrder.begin(), rankOrder.begin() + count);
+        computeRows(0);
+    } else {
+        // 第一个地标取出度与入度之和最大的单词；之后只在与它强连通的单词中，
+        // 选 min(d(L, v) + d(v, L)) 最大的单词（相同取编号最小），没有更远的单词时提前结束
+        WordId first = 0;
+        for (size_t v = 1; v < numNodes; ++v) {
+            uint64_t degree = outDegree(v) + (inOffsets[v + 1] - inOffsets[v]);
+            if (degree > outDegree(first) + (inOffsets[first + 1] - inOffsets[first])) {
+                first = static_cast<WordId>(v);
+            }
+        }
+        chosen.push_back(first);
+        computeRows(0);
+
+        std::vector<int64_t> score(numNodes, -1);
+        for (size_t v = 0; v < numNodes; ++v) {
+            if (fromRows[0][v] != infinity && toRows[0][v] != infinity) {
+                score[v] = fromRows[0][v] + toRows[0][v];
+            }
+        }
+        while (chosen.size() < count) {
+            size_t next = std::max_element(score.begin(), score.end()) - score.begin();
+            if (score[next] <= 0) break;
+            chosen.push_back(static_cast<WordId>(next));
+            computeRows(chosen.size() - 1);
+            for (size_t v = 0; v < numNodes; ++v) {
+                if (score[v] > 0) {
+                    score[v] = std::min(score[v], fromRows.back()[v] + toRows.back()[v]);
+                }
+            }
+        }
+    }
+
+    // 转成按单词连续存放，A* 计算下界时一次读取一个单词的全部地标距离
+    const size_t k = chosen.size();
+    std::vector<int64_t> from(numNodes * k), to(numNodes * k);
+    for (size_t v = 0; v < numNodes; ++v) {
+        for (size_t l = 0; l < k; ++l) {
+            from[v * k + l] = fromRows[l][v];
+            to[v * k + l] = toRows[l][v];
+        }
+    }
+    landmarks = std::move(chosen);
+    landmarkFrom = std::move(from);
+    landmarkTo = std::move(to);
+    return k;
+}
+
+// from 到 to 距离的下界；能够断定 from 无法到达 to 时返回无穷大
+int64_t Graph::landmarkBound(WordId from, WordId to) const {
+    const int64_t infinity = PathWorkspace::kInfinity;
+    const size_t k = landmarks.size();
+    const int64_t* landmarkToFrom = landmarkFrom.data() + from * k;
+    const int64_t* landmarkToTo = landmarkFrom.data() + to * k;
+    const int64_t* fromToLandmark = landmarkTo.data() + from * k;
+    const int64_t* toToLandmark = landmarkTo.data() + to * k;
+
+    int64_t bound = 0;
+    for (size_t l = 0; l < k; ++l) {
+        // L 能到达 from 却到不了 to，或 to 能到达 L 而 from 不能，说明 from 到不了 to
+        if (landmarkToFrom[l] != infinity) {
+            if (landmarkToTo[l] == infinity) return infinity;
+            bound = std::max(bound, landmarkToTo[l] - landmarkToFrom[l]);
+        }
+        if (toToLandmark[l] != infinity) {
+            if (fromToLandmark[l] == infinity) return infinity;
+            bound = std::max(bound, fromToLandmark[l] - toToLandmark[l]);
+        }
+    }
+    return bound;
+}
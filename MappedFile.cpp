@@ -0,0 +1,64 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& filePath) {
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return;
+    }
+    mappedSize = static_cast<size_t>(st.st_size);
+    if (mappedSize > 0) {
+        void* addr = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            mappedSize = 0;
+            return;
+        }
+        ::madvise(addr, mappedSize, MADV_SEQUENTIAL);
+        mapped = addr;
+    }
+    ::close(fd); // 映射建立后文件描述符即可关闭
+    opened = true;
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapped(other.mapped), mappedSize(other.mappedSize), opened(other.opened) {
+    other.mapped = nullptr;
+    other.mappedSize = 0;
+    other.opened = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapped = other.mapped;
+        mappedSize = other.mappedSize;
+        opened = other.opened;
+        other.mapped = nullptr;
+        other.mappedSize = 0;
+        other.opened = false;
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+    if (mapped != nullptr) {
+        ::munmap(mapped, mappedSize);
+    }
+    mapped = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// 只读内存映射文件，析构时自动解除映射
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return static_cast<const char*>(mapped); }
+    size_t size() const { return mappedSize; }
+    std::string_view view() const { return {data(), mappedSize}; }
+
+private:
+    void* mapped = nullptr;
+    size_t mappedSize = 0;
+    bool opened = false;
+
+    void release();
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,77 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+// xoshiro256**：256 位状态，每个随机数只需几次移位和乘法，比 std::mt19937 快得多，
+// 满足 UniformRandomBitGenerator，可直接交给 <random> 中的分布使用
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    // 用 splitmix64 把 64 位种子扩展成 256 位状态，相近的种子也得到无关的状态
+    explicit Xoshiro256(uint64_t seed) {
+        for (uint64_t& word : state) {
+            seed += 0x9e3779b97f4a7c15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // [0, bound) 内的均匀整数（Lemire 乘法映射，落入多余区间时重抽，没有取模偏差）；bound 须大于 0
+    uint32_t below(uint32_t bound) {
+        uint64_t product = ((*this)() >> 32) * bound;
+        if (static_cast<uint32_t>(product) < bound) {
+            const uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+            while (static_cast<uint32_t>(product) < threshold) {
+                product = ((*this)() >> 32) * bound;
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // 相当于调用 2^128 次 operator()：从同一种子依次跳跃得到的各个流互不重叠，可分给不同的任务
+    void jump() {
+        static constexpr uint64_t kJump[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                             0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+        uint64_t next[4] = {0, 0, 0, 0};
+        for (uint64_t mask : kJump) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (mask & (uint64_t(1) << bit)) {
+                    for (int i = 0; i < 4; ++i) {
+                        next[i] ^= state[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            state[i] = next[i];
+        }
+    }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,271 @@
+#include "Graph.h"
+#include "Random.h"
+#include "ThreadPool.h"
+
+#include <charconv>
+
+namespace {
+
+// 每块游走共用一个随机数流，也是写文件时并行格式化的单位
+const size_t kWalkBlock = 4096;
+
+// 一行出边的别名表：weights 为该行的 degree 个边权，threshold 和 alias 指向该行在别名表中的起始位置
+void buildAliasRow(const int* weights, uint32_t degree, uint32_t* threshold, uint32_t* alias) {
+    thread_local std::vector<uint64_t> scaled;
+    thread_local std::vector<uint32_t> small, large;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < degree; ++i) {
+        total += weights[i];
+        threshold[i] = UINT32_MAX;
+        alias[i] = i;
+    }
+
+    // 权重乘以出度后与总权重比较：小于总权重的列需要借用别的列补足
+    scaled.resize(degree);
+    small.clear();
+    large.clear();
+    for (uint32_t i = 0; i < degree; ++i) {
+        scaled[i] = static_cast<uint64_t>(weights[i]) * degree;
+        (scaled[i] < total ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back();
+        small.pop_back();
+        uint32_t l = large.back();
+        threshold[s] = static_cast<uint32_t>((static_cast<unsigned __int128>(scaled[s]) << 32) / total);
+        alias[s] = l;
+        scaled[l] -= total - scaled[s];
+        if (scaled[l] < total) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // 剩下的列恰好填满（阈值为 UINT32_MAX，别名指向自身）
+}
+
+} // namespace
+
+// 每个单词的出边一张别名表（Vose 方法），与出边 CSR 同样按边存放：第 i 列以 aliasThreshold / 2^32 的概率
+// 选中本列，否则选中第 aliasIndex 列。整数运算构造，没有浮点舍入，概率恰好正比于边权。
+// 各行互不影响，按编号均分成块交给线程池
+void Graph::rebuildAliasTables(unsigned threadCount) {
+    std::vector<uint32_t> threshold(outTargets.size());
+    std::vector<uint32_t> alias(outTargets.size());
+    ThreadPool pool(threadCount);
+    const size_t chunkCount = pool.size() == 1 ? 1 : pool.size() * 8;
+    pool.run(chunkCount, [&](size_t chunk) {
+        for (size_t u = wordCount() * chunk / chunkCount; u < wordCount() * (chunk + 1) / chunkCount; ++u) {
+            const uint64_t first = outOffsets[u];
+            buildAliasRow(outWeights.data() + first, static_cast<uint32_t>(outDegree(u)), threshold.data() + first,
+                          alias.data() + first);
+        }
+    });
+    aliasThreshold = std::move(threshold);
+    aliasIndex = std::move(alias);
+}
+
+// 只重建 rows（升序）各行的别名表。oldOffsets 为空时出边布局没有变化，原地重建；
+// 否则 rows 须包含所有出度变化的行，两个重建行之间的各行按旧偏移整段搬到新位置
+void Graph::updateAliasTables(const std::vector<WordId>& rows, const FrozenArray<uint64_t>* oldOffsets) {
+    auto buildRow = [&](WordId u, uint32_t* threshold, uint32_t* alias) {
+        const uint64_t first = outOffsets[u];
+        buildAliasRow(outWeights.data() + first, static_cast<uint32_t>(outDegree(u)), threshold + first,
+                      alias + first);
+    };
+    if (oldOffsets == nullptr) {
+        uint32_t* threshold = aliasThreshold.mutableData();
+        uint32_t* alias = aliasIndex.mutableData();
+        for (WordId u : rows) {
+            buildRow(u, threshold, alias);
+        }
+        return;
+    }
+
+    std::vector<uint32_t> threshold(outTargets.size());
+    std::vector<uint32_t> alias(outTargets.size());
+    size_t placed = 0;
+    auto moveRows = [&](size_t last) {
+        const uint64_t from = (*oldOffsets)[placed];
+        const uint64_t to = (*oldOffsets)[last];
+        std::copy(aliasThreshold.begin() + from, aliasThreshold.begin() + to, threshold.begin() + outOffsets[placed]);
+        std::copy(aliasIndex.begin() + from, aliasIndex.begin() + to, alias.begin() + outOffsets[placed]);
+    };
+    for (WordId u : rows) {
+        moveRows(u);
+        buildRow(u, threshold.data(), alias.data());
+        placed = u + 1;
+    }
+    moveRows(wordCount());
+    aliasThreshold = std::move(threshold);
+    aliasIndex = std::move(alias);
+}
+
+// 从 current 走一步，返回经过的出边编号（outTargets 中的下标），没有出边时返回 kNoEdge
+uint64_t Graph::walkEdge(WordId current, WalkMode mode, Xoshiro256& rng) const {
+    const uint64_t first = outOffsets[current];
+    const uint32_t degree = static_cast<uint32_t>(outOffsets[current + 1] - first);
+    if (degree == 0) {
+        return kNoEdge;
+    }
+    uint64_t edge = first + rng.below(degree);
+    if (mode == WalkMode::Weighted && static_cast<uint32_t>(rng()) >= aliasThreshold[edge]) {
+        edge = first + aliasIndex[edge];
+    }
+    return edge;
+}
+
+// 从 current 走一步，没有出边时返回 kNoWord
+Graph::WordId Graph::walkStep(WordId current, WalkMode mode, Xoshiro256& rng) const {
+    uint64_t edge = walkEdge(current, mode, rng);
+    return edge == kNoEdge ? kNoWord : outTargets[edge];
+}
+
+std::string Graph::randomWalk(WalkMode mode) const {
+    WalkPolicy policy;
+    policy.mode = mode;
+    return randomWalk(policy);
+}
+
+// 经过的边记录在按边编号的位图中，判断重复边为 O(1)，不保存任何字符串。
+// 位图每个线程一份、随图的边数增长（E / 64 个字），与游走长度无关；
+// 游走结束后只清除置过位的字，因此每条游走的清理开销与步数成正比
+std::string Graph::randomWalk(const WalkPolicy& policy) const {
+    if (wordCount() == 0) {
+        return "";
+    }
+
+    std::random_device rd;
+    Xoshiro256 rng((static_cast<uint64_t>(rd()) << 32) | rd());
+    const WordId start = rng.below(static_cast<uint32_t>(wordCount()));
+    // 重启概率换算成 64 位阈值，只在限制了长度时生效，否则游走可能永远不结束
+    uint64_t restartThreshold = 0;
+    if (policy.maxLength > 0 && policy.restartProbability > 0) {
+        restartThreshold = policy.restartProbability >= 1 ? UINT64_MAX
+                                                          : static_cast<uint64_t>(std::ldexp(policy.restartProbability, 64));
+    }
+
+    thread_local std::vector<uint64_t> visited;
+    thread_local std::vector<uint64_t> touched;
+    if (policy.stopOnRepeatedEdge) {
+        visited.resize(std::max(visited.size(), (outTargets.size() + 63) / 64), 0);
+    }
+
+    WordId current = start;
+    std::string walk(wordAt(current));
+    size_t length = 1;
+    while (policy.maxLength == 0 || length < policy.maxLength) {
+        if (restartThreshold != 0 && rng() < restartThreshold) {
+            current = start;
+            walk += " | ";
+            walk += wordAt(current);
+            ++length;
+            continue;
+        }
+        uint64_t edge = walkEdge(current, policy.mode, rng);
+        if (edge == kNoEdge) {
+            break;
+        }
+        current = outTargets[edge];
+        walk += " -> ";
+        walk += wordAt(current);
+        ++length;
+        if (policy.stopOnRepeatedEdge) {
+            uint64_t& word = visited[edge / 64];
+            const uint64_t bit = uint64_t(1) << (edge % 64);
+            if (word & bit) {
+                break;
+            }
+            if (word == 0) {
+                touched.push_back(edge / 64);
+            }
+            word |= bit;
+        }
+    }
+
+    for (uint64_t index : touched) {
+        visited[index] = 0;
+    }
+    touched.clear();
+    return walk;
+}
+
+// 第 b 块使用主种子的流跳跃 b 次后的状态
+std::vector<Xoshiro256> Graph::walkStreams(size_t numWalks, uint64_t seed) const {
+    const size_t blocks = (numWalks + kWalkBlock - 1) / kWalkBlock;
+    std::vector<Xoshiro256> streams;
+    streams.reserve(blocks);
+    Xoshiro256 rng(seed);
+    for (size_t b = 0; b < blocks; ++b) {
+        streams.push_back(rng);
+        rng.jump();
+    }
+    return streams;
+}
+
+void Graph::runWalkBlock(size_t block, size_t numWalks, size_t maxLength, WalkMode mode, Xoshiro256& rng,
+                         std::vector<WordId>& walk,
+                         const std::function<void(size_t index, std::span<const WordId> walk)>& visit) const {
+    const size_t end = std::min(numWalks, (block + 1) * kWalkBlock);
+    for (size_t index = block * kWalkBlock; index < end; ++index) {
+        walk.clear();
+        WordId current = static_cast<WordId>(index % wordCount());
+        do {
+            walk.push_back(current);
+        } while (walk.size() < maxLength && (current = walkStep(current, mode, rng)) != kNoWord);
+        visit(index, walk);
+    }
+}
+
+void Graph::generateWalks(size_t numWalks, size_t maxLength, uint64_t seed,
+                          const std::function<void(size_t index, std::span<const WordId> walk)>& visit,
+                          unsigned threadCount, WalkMode mode) const {
+    if (wordCount() == 0 || maxLength == 0) {
+        return;
+    }
+    std::vector<Xoshiro256> streams = walkStreams(numWalks, seed);
+    ThreadPool pool(threadCount);
+    pool.run(streams.size(), [&](size_t block) {
+        thread_local std::vector<WordId> walk;
+        runWalkBlock(block, numWalks, maxLength, mode, streams[block], walk, visit);
+    });
+}
+
+bool Graph::generateWalksFile(const std::string& outputPath, size_t numWalks, size_t maxLength, uint64_t seed,
+                              unsigned threadCount, WalkMode mode) const {
+    std::ofstream outFile(outputPath, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "无法打开输出文件: " << outputPath << std::endl;
+        return false;
+    }
+    if (wordCount() == 0 || maxLength == 0) {
+        return true;
+    }
+
+    // 每轮并行格式化 pool.size() 块，再按块的顺序整块写出
+    std::vector<Xoshiro256> streams = walkStreams(numWalks, seed);
+    ThreadPool pool(threadCount);
+    std::vector<std::string> outputs(pool.size());
+    for (size_t first = 0; first < streams.size(); first += outputs.size()) {
+        size_t filled = std::min(outputs.size(), streams.size() - first);
+        pool.run(filled, [&](size_t i) {
+            thread_local std::vector<WordId> walk;
+            std::string& output = outputs[i];
+            output.clear();
+            runWalkBlock(first + i, numWalks, maxLength, mode, streams[first + i], walk,
+                         [&](size_t, std::span<const WordId> ids) {
+                char digits[16];
+                for (size_t j = 0; j < ids.size(); ++j) {
+                    if (j > 0) {
+                        output += ' ';
+                    }
+                    output.append(digits, std::to_chars(digits, digits + sizeof(digits), ids[j]).ptr);
+                }
+                output += '\n';
+            });
+        });
+        for (size_t i = 0; i < filled; ++i) {
+            outFile.write(outputs[i].data(), static_cast<std::streamsize>(outputs[i].size()));
+        }
+    }
+    return outFile.good();
+}
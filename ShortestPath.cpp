@@ -0,0 +1,59 @@
+#include "ShortestPath.h"
+
+#include <algorithm>
+
+void RadixHeap::push(uint64_t key, uint32_t value) {
+    buckets[bucketOf(key)].emplace_back(key, value);
+    ++count;
+}
+
+// 取第一个非空桶的最小键作为新的基准，其余元素按新基准重新分到更低的桶
+void RadixHeap::refill() {
+    if (!buckets[0].empty()) {
+        return;
+    }
+    size_t i = 1;
+    while (buckets[i].empty()) {
+        ++i;
+    }
+    auto& source = buckets[i];
+    last = std::min_element(source.begin(), source.end())->first;
+    for (const auto& item : source) {
+        buckets[bucketOf(item.first)].push_back(item);
+    }
+    source.clear();
+}
+
+uint64_t RadixHeap::topKey() {
+    refill();
+    return last;
+}
+
+std::pair<uint64_t, uint32_t> RadixHeap::pop() {
+    refill();
+    auto top = buckets[0].back();
+    buckets[0].pop_back();
+    --count;
+    return top;
+}
+
+void RadixHeap::clear() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    last = 0;
+    count = 0;
+}
+
+void PathWorkspace::begin(size_t nodeCount) {
+    if (stamp.size() < nodeCount) {
+        stamp.resize(nodeCount, 0);
+        dist.resize(nodeCount);
+        pred.resize(nodeCount);
+    }
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    heap.clear();
+}
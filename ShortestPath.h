@@ -0,0 +1,74 @@
+#ifndef SHORTEST_PATH_H
+#define SHORTEST_PATH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 单调整数优先队列（基数堆）：弹出的键不减时成立，Dijkstra 的距离恰好满足。
+// 第 i 个桶存放与上次弹出的键最高不同位为第 i 位的元素，push 为 O(1)，
+// 每个元素在被弹出前最多被重新分桶 64 次，且不需要比较相同距离之间的先后
+class RadixHeap {
+public:
+    void push(uint64_t key, uint32_t value);
+    // 调用前需保证非空；弹出键最小的元素之一
+    std::pair<uint64_t, uint32_t> pop();
+    // 调用前需保证非空；返回最小键但不弹出
+    uint64_t topKey();
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    // 清空但保留各桶的容量，下一次查询无需重新分配
+    void clear();
+
+private:
+    std::vector<std::pair<uint64_t, uint32_t>> buckets[65];
+    uint64_t last = 0;
+    size_t count = 0;
+
+    size_t bucketOf(uint64_t key) const { return key == last ? 0 : 64 - __builtin_clzll(key ^ last); }
+    void refill();
+};
+
+// 最短路查询的可复用工作区：距离和前驱按节点编号存放，用查询轮次标记哪些项属于本次查询，
+// 因此每次查询的初始化是 O(1)，不必重新填充 O(V) 的数组
+class PathWorkspace {
+public:
+    static constexpr int64_t kInfinity = INT64_MAX;
+
+    // 开始新一轮查询；节点数变大时扩容，轮次计数回绕时才整体清零一次
+    void begin(size_t nodeCount);
+
+    bool reached(uint32_t node) const { return stamp[node] == epoch; }
+    int64_t distance(uint32_t node) const { return reached(node) ? dist[node] : kInfinity; }
+    uint32_t predecessor(uint32_t node) const { return pred[node]; }
+    void set(uint32_t node, int64_t distance, uint32_t predecessor) {
+        stamp[node] = epoch;
+        dist[node] = distance;
+        pred[node] = predecessor;
+    }
+    // 经由 from（距离 fromDistance）到达 node 的新距离为 newDistance：更短时更新并入堆；
+    // 与当前距离相等时保留 (距离, 编号) 较小的前驱，使并列的最短路不依赖出堆顺序
+    void relax(uint32_t node, int64_t newDistance, uint32_t from, int64_t fromDistance) {
+        int64_t current = distance(node);
+        if (newDistance < current) {
+            set(node, newDistance, from);
+            heap.push(newDistance, node);
+        } else if (newDistance == current && pred[node] != UINT32_MAX) {
+            int64_t previousDistance = dist[pred[node]];
+            if (fromDistance < previousDistance || (fromDistance == previousDistance && from < pred[node])) {
+                pred[node] = from;
+            }
+        }
+    }
+
+    RadixHeap heap;
+
+private:
+    std::vector<uint32_t> stamp;
+    std::vector<int64_t> dist;
+    std::vector<uint32_t> pred;
+    uint32_t epoch = 0;
+};
+
+#endif // SHORTEST_PATH_H
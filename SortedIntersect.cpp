@@ -0,0 +1,113 @@
+#include "SortedIntersect.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define SORTED_INTERSECT_SSE2 1
+#endif
+
+namespace {
+
+// 长度比超过该值时改用跳跃查找
+const size_t kGallopRatio = 32;
+
+// 在 [from, n) 中找第一个不小于 value 的位置：先按 1, 2, 4, ... 倍增步长越过，再二分
+size_t gallop(const uint32_t* data, size_t from, size_t n, uint32_t value) {
+    size_t step = 1;
+    size_t lo = from;
+    size_t hi = from;
+    while (hi < n && data[hi] < value) {
+        lo = hi + 1;
+        hi = from + step;
+        step *= 2;
+    }
+    return std::lower_bound(data + lo, data + std::min(hi, n), value) - data;
+}
+
+// emit(value) 返回 false 时提前结束；返回值表示是否被提前结束
+template <typename Emit>
+bool intersectGallop(const uint32_t* small, size_t ns, const uint32_t* large, size_t nl, Emit&& emit) {
+    size_t j = 0;
+    for (size_t i = 0; i < ns && j < nl; ++i) {
+        j = gallop(large, j, nl, small[i]);
+        if (j < nl && large[j] == small[i] && !emit(small[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Emit>
+bool intersectMerge(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, Emit&& emit) {
+    size_t i = 0;
+    size_t j = 0;
+#ifdef SORTED_INTERSECT_SSE2
+    // 每次取两边各 4 个元素，与 b 块的四种循环移位逐一比较，得到 a 块中命中元素的掩码
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(hit));
+        for (; mask != 0; mask &= mask - 1) {
+            if (!emit(a[i + __builtin_ctz(mask)])) {
+                return true;
+            }
+        }
+        uint32_t lastA = a[i + 3];
+        uint32_t lastB = b[j + 3];
+        i += lastA <= lastB ? 4 : 0;
+        j += lastB <= lastA ? 4 : 0;
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            if (!emit(a[i])) {
+                return true;
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return false;
+}
+
+template <typename Emit>
+bool intersectWith(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, Emit&& emit) {
+    if (na == 0 || nb == 0) {
+        return false;
+    }
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb / na >= kGallopRatio) {
+        return intersectGallop(a, na, b, nb, emit);
+    }
+    return intersectMerge(a, na, b, nb, emit);
+}
+
+} // namespace
+
+size_t intersectSorted(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    size_t count = 0;
+    intersectWith(a, na, b, nb, [&](uint32_t value) {
+        out[count++] = value;
+        return true;
+    });
+    return count;
+}
+
+bool firstCommon(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t& common) {
+    return intersectWith(a, na, b, nb, [&](uint32_t value) {
+        common = value;
+        return false;
+    });
+}
@@ -0,0 +1,15 @@
+#ifndef SORTED_INTERSECT_H
+#define SORTED_INTERSECT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 求两个严格递增的 uint32_t 序列的交集，结果按升序写入 out（至少 min(na, nb) 个元素），
+// 返回交集大小。长度相差悬殊时对短序列逐个做跳跃（galloping）查找，
+// 否则使用 SSE2 的 4x4 分块比较，非 x86 平台退化为标量归并
+size_t intersectSorted(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out);
+
+// 策略相同，但找到最小的公共元素后立即返回；没有公共元素时返回 false
+bool firstCommon(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t& common);
+
+#endif // SORTED_INTERSECT_H
@@ -0,0 +1,173 @@
+#include "TextKernel.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TEXT_KERNEL_X86 1
+#endif
+
+namespace {
+
+inline bool isPunct(unsigned char c) {
+    return (c >= '!' && c <= '/') || (c >= ':' && c <= '@') || (c >= '[' && c <= '`') || (c >= '{' && c <= '~');
+}
+
+inline char toLowerAscii(unsigned char c) {
+    return static_cast<char>((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+}
+
+size_t normalizeScalar(const char* src, size_t length, char* dst) {
+    size_t out = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(src[i]);
+        dst[out] = toLowerAscii(c);
+        out += !isPunct(c);
+    }
+    return out;
+}
+
+// 按掩码无分支地压缩一个块：每个字节都写出，只有保留的字节推进输出位置。
+// 输出位置永远不超过输入位置，因此原地处理也是安全的。
+inline size_t compactBlock(const char* lowered, uint32_t keep, size_t width, char* out) {
+    size_t n = 0;
+    for (size_t i = 0; i < width; ++i) {
+        out[n] = lowered[i];
+        n += (keep >> i) & 1u;
+    }
+    return n;
+}
+
+#ifdef TEXT_KERNEL_X86
+
+// 8 字节压缩用的 pshufb 控制字：第 m 项把掩码 m 中置位的字节依次移到低位
+struct CompressTable {
+    uint64_t shuffle[256];
+    constexpr CompressTable() : shuffle() {
+        for (int mask = 0; mask < 256; ++mask) {
+            uint64_t control = 0;
+            int n = 0;
+            for (int i = 0; i < 8; ++i) {
+                if (mask & (1 << i)) {
+                    control |= static_cast<uint64_t>(i) << (8 * n++);
+                }
+            }
+            shuffle[mask] = control;
+        }
+    }
+};
+
+constexpr CompressTable kCompressTable;
+
+__attribute__((target("sse2")))
+inline __m128i inRange16(__m128i x, char lo, char hi) {
+    __m128i t = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    __m128i span = _mm_set1_epi8(static_cast<char>(hi - lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(t, span), t);
+}
+
+__attribute__((target("sse2")))
+size_t normalizeSse2(const char* src, size_t length, char* dst) {
+    size_t in = 0;
+    size_t out = 0;
+    alignas(16) char lowered[16];
+    for (; in + 16 <= length; in += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + in));
+        __m128i punct = _mm_or_si128(_mm_or_si128(inRange16(x, '!', '/'), inRange16(x, ':', '@')),
+                                     _mm_or_si128(inRange16(x, '[', '`'), inRange16(x, '{', '~')));
+        __m128i upper = inRange16(x, 'A', 'Z');
+        __m128i lower = _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+        uint32_t drop = static_cast<uint32_t>(_mm_movemask_epi8(punct));
+        if (drop == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + out), lower);
+            out += 16;
+        } else {
+            _mm_store_si128(reinterpret_cast<__m128i*>(lowered), lower);
+            out += compactBlock(lowered, ~drop & 0xFFFFu, 16, dst + out);
+        }
+    }
+    return out + normalizeScalar(src + in, length - in, dst + out);
+}
+
+__attribute__((target("avx2")))
+inline __m256i inRange32(__m256i x, char lo, char hi) {
+    __m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    __m256i span = _mm256_set1_epi8(static_cast<char>(hi - lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(t, span), t);
+}
+
+__attribute__((target("avx2")))
+size_t normalizeAvx2(const char* src, size_t length, char* dst) {
+    size_t in = 0;
+    size_t out = 0;
+    alignas(32) char lowered[32];
+    for (; in + 32 <= length; in += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + in));
+        __m256i punct = _mm256_or_si256(_mm256_or_si256(inRange32(x, '!', '/'), inRange32(x, ':', '@')),
+                                        _mm256_or_si256(inRange32(x, '[', '`'), inRange32(x, '{', '~')));
+        __m256i upper = inRange32(x, 'A', 'Z');
+        __m256i lower = _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+        uint32_t drop = static_cast<uint32_t>(_mm256_movemask_epi8(punct));
+        if (drop == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + out), lower);
+            out += 32;
+        } else {
+            // 每 8 字节一组用 pshufb 压缩，每次写 8 字节但只推进保留的字节数；
+            // 写入范围不会超出当前已读入的块，因此原地处理仍然安全
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lowered), lower);
+            uint32_t keep = ~drop;
+            for (int group = 0; group < 4; ++group) {
+                uint32_t mask = (keep >> (8 * group)) & 0xFFu;
+                __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(lowered + 8 * group));
+                __m128i control = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kCompressTable.shuffle[mask]));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + out), _mm_shuffle_epi8(bytes, control));
+                out += __builtin_popcount(mask);
+            }
+        }
+    }
+    return out + normalizeSse2(src + in, length - in, dst + out);
+}
+
+#endif // TEXT_KERNEL_X86
+
+TextKernel selectKernel() {
+#ifdef TEXT_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", normalizeAvx2};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {"sse2", normalizeSse2};
+    }
+#endif
+    return {"scalar", normalizeScalar};
+}
+
+const TextKernel& activeKernel() {
+    static const TextKernel kernel = selectKernel();
+    return kernel;
+}
+
+} // namespace
+
+size_t normalizeText(const char* src, size_t length, char* dst) {
+    return activeKernel().normalize(src, length, dst);
+}
+
+std::vector<TextKernel> availableTextKernels() {
+    std::vector<TextKernel> kernels = {{"scalar", normalizeScalar}};
+#ifdef TEXT_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels.push_back({"sse2", normalizeSse2});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back({"avx2", normalizeAvx2});
+    }
+#endif
+    return kernels;
+}
+
+const char* activeTextKernelName() {
+    return activeKernel().name;
+}
@@ -0,0 +1,23 @@
+#ifndef TEXT_KERNEL_H
+#define TEXT_KERNEL_H
+
+#include <cstddef>
+#include <vector>
+
+// 删除 "C" locale 下的标点字符并把大写字母转为小写，结果与
+// 逐字节 std::ispunct 过滤再 ::tolower 的结果完全一致。
+// dst 至少需要 length 字节，可以与 src 相同（原地处理），返回写入的字节数。
+size_t normalizeText(const char* src, size_t length, char* dst);
+
+struct TextKernel {
+    const char* name;
+    size_t (*normalize)(const char* src, size_t length, char* dst);
+};
+
+// 当前 CPU 可用的全部实现（标量、SSE2、AVX2），供基准测试和一致性检查使用
+std::vector<TextKernel> availableTextKernels();
+
+// normalizeText 在运行时选中的实现名称
+const char* activeTextKernelName();
+
+#endif // TEXT_KERNEL_H
@@ -0,0 +1,78 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+unsigned ThreadPool::resolveThreadCount(unsigned threadCount) {
+    return threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    threadCount = resolveThreadCount(threadCount);
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextTask.store(0, std::memory_order_relaxed);
+        activeWorkers = static_cast<unsigned>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    drainTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return activeWorkers == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::drainTasks() {
+    for (size_t i = nextTask.fetch_add(1, std::memory_order_relaxed); i < taskCount;
+         i = nextTask.fetch_add(1, std::memory_order_relaxed)) {
+        (*currentTask)(i);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    size_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        drainTasks();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--activeWorkers == 0) {
+            done.notify_one();
+        }
+    }
+}
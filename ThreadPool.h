@@ -0,0 +1,44 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的线程池，run() 把一批编号任务分给各线程（调用线程也参与）并等待全部完成。
+// 适合迭代算法中反复执行的同构并行循环，避免每轮重新创建线程
+class ThreadPool {
+public:
+    // threadCount 为 0 时使用全部硬件线程；为 1 时不创建额外线程
+    explicit ThreadPool(unsigned threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+    void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+    static unsigned resolveThreadCount(unsigned threadCount);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* currentTask = nullptr;
+    size_t taskCount = 0;
+    std::atomic<size_t> nextTask{0};
+    size_t generation = 0;
+    unsigned activeWorkers = 0;
+    bool stopping = false;
+
+    void workerLoop();
+    void drainTasks();
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,303 @@
+#include "Graph.h"
+#include "MappedFile.h"
+#include "TextKernel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 1, 2, 4, ... 直到硬件线程数（最后一项总是硬件线程数）
+std::vector<unsigned> threadCounts() {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+// 原 generateGraph 的做法：逐字节 ispunct 追加到新字符串，再 transform 一遍 tolower
+size_t legacyNormalize(const char* src, size_t length, char* dst) {
+    std::string result;
+    for (size_t i = 0; i < length; ++i) {
+        if (!std::ispunct(src[i])) {
+            result += src[i];
+        }
+    }
+    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+    std::copy(result.begin(), result.end(), dst);
+    return result.size();
+}
+
+// 与 ingestText 相同，按行调用内核，返回 MB/s
+double measureKernel(size_t (*normalize)(const char*, size_t, char*), std::string_view text, int rounds, std::string& output) {
+    output.assign(text.size(), '\0');
+    auto start = Clock::now();
+    size_t written = 0;
+    for (int r = 0; r < rounds; ++r) {
+        written = 0;
+        const char* p = text.data();
+        const char* end = p + text.size();
+        while (p < end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (lineEnd == nullptr) {
+                lineEnd = end;
+            }
+            written += normalize(p, lineEnd - p, output.data() + written);
+            p = lineEnd + 1;
+        }
+    }
+    double seconds = secondsSince(start);
+    output.resize(written);
+    return text.size() * static_cast<double>(rounds) / seconds / 1e6;
+}
+
+void benchNormalize(std::string_view text) {
+    const int rounds = 20;
+    std::string expected;
+    double legacy = measureKernel(legacyNormalize, text, rounds, expected);
+    std::cout << "normalize legacy      " << std::fixed << std::setprecision(1) << legacy << " MB/s\n";
+
+    for (const auto& kernel : availableTextKernels()) {
+        std::string output;
+        double rate = measureKernel(kernel.normalize, text, rounds, output);
+        std::cout << "normalize " << std::left << std::setw(12) << kernel.name << std::right
+                  << rate << " MB/s (x" << std::setprecision(2) << rate / legacy << std::setprecision(1) << ")"
+                  << (output == expected ? "" : "  输出不一致!") << "\n";
+    }
+    std::cout << "active kernel: " << activeTextKernelName() << "\n";
+}
+
+void benchIngestion(const std::string& filePath, size_t fileSize) {
+    double serial = 0.0;
+    for (unsigned threads : threadCounts()) {
+        auto start = Clock::now();
+        Graph graph;
+        graph.generateGraph(filePath, threads);
+        double seconds = secondsSince(start);
+        if (threads == 1) {
+            serial = seconds;
+        }
+        std::cout << "generateGraph threads=" << threads << "  " << std::fixed << std::setprecision(1)
+                  << fileSize / seconds / 1e6 << " MB/s (x" << std::setprecision(2) << serial / seconds << ")\n";
+    }
+}
+
+// 同一张图上以 1..N 个线程计算 PageRank，报告加速比并确认结果逐位一致
+void benchPageRank(const std::string& filePath) {
+    Graph graph;
+    graph.generateGraph(filePath, 0);
+
+    std::vector<double> expected;
+    double serial = 0.0;
+    for (unsigned threads : threadCounts()) {
+        Graph copy = graph;
+        auto start = Clock::now();
+        copy.calculatePageRank(0.85, threads);
+        double seconds = secondsSince(start);
+        std::vector<double> ranks;
+        for (size_t id = 0; id < copy.wordCount(); ++id) {
+            ranks.push_back(copy.calcPageRank(std::string(copy.wordAt(id))));
+        }
+        if (threads == 1) {
+            serial = seconds;
+            expected = ranks;
+        }
+        std::cout << "calculatePageRank threads=" << threads << "  " << std::fixed << std::setprecision(2)
+                  << seconds * 1e3 << " ms (x" << serial / seconds << ")"
+                  << (ranks == expected ? "" : "  结果与单线程不一致!") << "\n";
+    }
+}
+
+// 单个随机种子的个性化 PageRank（默认阈值），与上面的全局 PageRank 耗时对照
+void benchPersonalizedPageRank(const std::string& filePath) {
+    Graph graph;
+    graph.generateGraph(filePath, 0);
+    if (graph.wordCount() == 0) return;
+
+    const int queries = 1000;
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<size_t> dis(0, graph.wordCount() - 1);
+    size_t returned = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        returned += graph.personalizedPageRank({std::string(graph.wordAt(dis(gen)))}, graph.wordCount()).size();
+    }
+    double seconds = secondsSince(start);
+    std::cout << "personalizedPageRank  " << std::fixed << std::setprecision(3) << seconds * 1e3 / queries
+              << " ms/query (" << returned / queries << " words/query)\n";
+}
+
+// 随机单词对的点到点最短路查询，报告平均每次查询耗时；再分别以两种方式建立地标后重测，
+// 用来判断地标在这张图上是否划算
+void benchShortestPath(const std::string& filePath) {
+    Graph graph;
+    graph.generateGraph(filePath, 0);
+    if (graph.wordCount() == 0) return;
+
+    const int queries = 2000;
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<size_t> dis(0, graph.wordCount() - 1);
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (int i = 0; i < queries; ++i) {
+        pairs.emplace_back(graph.wordAt(dis(gen)), graph.wordAt(dis(gen)));
+    }
+
+    std::vector<std::string> expected;
+    auto measure = [&](const char* name, const Graph& g) {
+        std::vector<std::string> paths;
+        auto start = Clock::now();
+        for (const auto& [from, to] : pairs) {
+            paths.push_back(g.calcShortestPath(from, to));
+        }
+        double seconds = secondsSince(start);
+        if (expected.empty()) {
+            expected = paths;
+        }
+        std::cout << "calcShortestPath " << std::left << std::setw(10) << name << std::right << std::fixed
+                  << std::setprecision(1) << seconds * 1e6 / queries << " us/query"
+                  << (paths == expected ? "" : "  结果不一致!") << "\n";
+    };
+    measure("", graph);
+
+    for (auto selection : {Graph::LandmarkSelection::Farthest, Graph::LandmarkSelection::PageRank}) {
+        Graph withLandmarks = graph;
+        auto start = Clock::now();
+        withLandmarks.buildLandmarks(16, selection, 0);
+        std::cout << "buildLandmarks " << (selection == Graph::LandmarkSelection::Farthest ? "farthest" : "pagerank")
+                  << "  " << std::setprecision(1) << secondsSince(start) * 1e3 << " ms\n";
+        measure(selection == Graph::LandmarkSelection::Farthest ? "farthest" : "pagerank", withLandmarks);
+    }
+}
+
+// 随机单词对的前 10 短无环路径
+void benchKShortestPaths(const std::string& filePath) {
+    Graph graph;
+    graph.generateGraph(filePath, 0);
+    if (graph.wordCount() == 0) return;
+
+    const int queries = 200;
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<size_t> dis(0, graph.wordCount() - 1);
+    size_t found = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        found += graph.kShortestPaths(std::string(graph.wordAt(dis(gen))), std::string(graph.wordAt(dis(gen))), 10).size();
+    }
+    double seconds = secondsSince(start);
+    std::cout << "kShortestPaths k=10  " << std::fixed << std::setprecision(2) << seconds * 1e3 / queries
+              << " ms/query (" << found << " paths)\n";
+}
+
+// 前 1000 个单词作为源点的批量单源最短路，按线程数报告吞吐
+void benchShortestPathsFromMany(const std::string& filePath) {
+    Graph graph;
+    graph.generateGraph(filePath, 0);
+    std::vector<Graph::WordId> sources;
+    for (size_t id = 0; id < std::min<size_t>(graph.wordCount(), 1000); ++id) {
+        sources.push_back(static_cast<Graph::WordId>(id));
+    }
+    if (sources.empty()) return;
+
+    double serial = 0.0;
+    for (unsigned threads : threadCounts()) {
+        std::atomic<int64_t> checksum{0};
+        auto start = Clock::now();
+        graph.shortestPathsFromMany(sources, [&](size_t, const Graph::ShortestPathTree& tree) {
+            int64_t sum = 0;
+            for (int64_t d : tree.distances) {
+                sum += d == Graph::kUnreachable ? 0 : d;
+            }
+            checksum += sum;
+        }, threads);
+        double seconds = secondsSince(start);
+        if (threads == 1) {
+            serial = seconds;
+        }
+        std::cout << "shortestPathsFromMany threads=" << threads << "  " << std::fixed << std::setprecision(1)
+                  << sources.size() / seconds << " sources/s (x" << std::setprecision(2) << serial / seconds << ")\n";
+    }
+}
+
+// 批量随机游走（长度上限 80），按线程数报告每秒步数。计时包含写入游走缓冲区和每条游走一次的回调。
+// 按权游走每步多抽一个 32 位随机数，并多读一次 aliasThreshold（约一半的步还要读 aliasIndex），
+// 在单核上约为等概率游走的一半：样例语料上分别约 50M 和 100M 步/秒，机器负载不同时数值差别较大
+void benchGenerateWalks(const std::string& filePath) {
+    Graph graph;
+    graph.generateGraph(filePath, 0);
+    if (graph.wordCount() == 0) return;
+
+    const size_t numWalks = 200000, maxLength = 80;
+    for (Graph::WalkMode mode : {Graph::WalkMode::Uniform, Graph::WalkMode::Weighted}) {
+        double serial = 0.0;
+        for (unsigned threads : threadCounts()) {
+            std::atomic<size_t> steps{0};
+            auto start = Clock::now();
+            graph.generateWalks(numWalks, maxLength, 1, [&](size_t, std::span<const Graph::WordId> walk) {
+                steps.fetch_add(walk.size() - 1, std::memory_order_relaxed);
+            }, threads, mode);
+            double seconds = secondsSince(start);
+            if (threads == 1) {
+                serial = seconds;
+            }
+            std::cout << "generateWalks " << (mode == Graph::WalkMode::Uniform ? "uniform " : "weighted") << " threads="
+                      << threads << "  " << std::fixed << std::setprecision(1) << steps / seconds / 1e6 << " M steps/s (x"
+                      << std::setprecision(2) << serial / seconds << ")\n";
+        }
+    }
+}
+
+// 各导出格式的输出速度
+void benchExport(const std::string& filePath) {
+    Graph graph;
+    graph.generateGraph(filePath, 0);
+    const std::string outputPath = "bench_export.out";
+    const std::pair<Graph::ExportFormat, const char*> formats[] = {
+        {Graph::ExportFormat::Dot, "dot     "},
+        {Graph::ExportFormat::Tsv, "tsv     "},
+        {Graph::ExportFormat::GraphML, "graphml "},
+        {Graph::ExportFormat::BinaryEdges, "binary  "},
+    };
+    for (const auto& [format, name] : formats) {
+        for (unsigned threads : threadCounts()) {
+            auto start = Clock::now();
+            graph.exportGraph(outputPath, format, threads);
+            double seconds = secondsSince(start);
+            MappedFile output(outputPath);
+            std::cout << "export " << name << "threads=" << threads << "  " << std::fixed << std::setprecision(1)
+                      << output.size() / seconds / 1e6 << " MB/s\n";
+        }
+    }
+    std::remove(outputPath.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filePath = argc > 1 ? argv[1] : "Cursed Be The Treasure.txt";
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
+        std::cerr << "无法打开文件: " << filePath << std::endl;
+        return 1;
+    }
+
+    benchNormalize(file.view());
+    benchIngestion(filePath, file.size());
+    benchPageRank(filePath);
+    benchPersonalizedPageRank(filePath);
+    benchShortestPath(filePath);
+    benchKShortestPaths(filePath);
+    benchShortestPathsFromMany(filePath);
+    benchGenerateWalks(filePath);
+    benchExport(filePath);
+    return 0;
+}
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 #include "Graph.h"
+#include "ShortestPath.h"
+#include "SortedIntersect.h"
+#include "TextKernel.h"
+
+#include <cstring>
+#include <map>
+#include <set>
 
 class GraphTest : public ::testing::Test {
 protected:
@@ -122,6 +129,1294 @@ TEST_F(GraphTest, QueryBridgeWords_Test6) {
     EXPECT_EQ(expectedBridgeWords, actualBridgeWords);
 }
 
+TEST_F(GraphTest, CalcShortestPath_Test1) {
+    EXPECT_EQ("the -> team -> requested", graph.calcShortestPath("the", "requested"));
+    EXPECT_EQ("scientist -> analyzed -> it -> again", graph.calcShortestPath("scientist", "again"));
+    EXPECT_EQ("the", graph.calcShortestPath("the", "the"));
+}
+
+TEST_F(GraphTest, CalcShortestPath_Test2) {
+    EXPECT_EQ("No path found", graph.calcShortestPath("again", "the"));
+    EXPECT_EQ("No path found", graph.calcShortestPath("nonono", "the"));
+}
+
+TEST_F(GraphTest, WordIds_Test1) {
+    EXPECT_EQ(19u, graph.wordCount());
+    for (size_t id = 0; id < graph.wordCount(); ++id) {
+        EXPECT_EQ(id, graph.findWord(graph.wordAt(id)));
+        if (id > 0) {
+            EXPECT_LT(graph.wordAt(id - 1), graph.wordAt(id));
+        }
+    }
+    EXPECT_EQ(Graph::kNoWord, graph.findWord("nonono"));
+}
+
+TEST(TextKernelTest, NormalizeText_Test1) {
+    std::string input;
+    for (int round = 0; round < 3; ++round) {
+        for (int c = 0; c < 256; ++c) {
+            input += static_cast<char>(c);
+        }
+    }
+    input += "The scientist carefully analyzed the data, wrote a detailed report.";
+
+    std::string expected;
+    for (char c : input) {
+        if (!std::ispunct(c)) {
+            expected += c;
+        }
+    }
+    std::transform(expected.begin(), expected.end(), expected.begin(), ::tolower);
+
+    for (const auto& kernel : availableTextKernels()) {
+        for (size_t offset = 0; offset < 40; ++offset) {
+            std::string output(input.size() - offset, '\0');
+            output.resize(kernel.normalize(input.data() + offset, input.size() - offset, output.data()));
+            std::string reference = input.substr(offset);
+            reference.erase(std::remove_if(reference.begin(), reference.end(), [](char c) { return std::ispunct(c); }), reference.end());
+            std::transform(reference.begin(), reference.end(), reference.begin(), ::tolower);
+            EXPECT_EQ(reference, output) << kernel.name << " offset " << offset;
+        }
+        std::string inPlace = input;
+        inPlace.resize(kernel.normalize(inPlace.data(), inPlace.size(), inPlace.data()));
+        EXPECT_EQ(expected, inPlace) << kernel.name;
+    }
+}
+
+// 捕获 showDirectedGraph 的输出并排序，使结果与 unordered_map 的遍历顺序无关
+std::string sortedGraphDump(const Graph& graph) {
+    std::ostringstream captured;
+    std::streambuf* original = std::cout.rdbuf(captured.rdbuf());
+    graph.showDirectedGraph();
+    std::cout.rdbuf(original);
+
+    std::vector<std::string> lines;
+    std::istringstream in(captured.str());
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (fields >> token) {
+            tokens.push_back(token);
+        }
+        if (!tokens.empty()) {
+            std::sort(tokens.begin() + 1, tokens.end());
+        }
+        std::ostringstream joined;
+        for (const auto& t : tokens) {
+            joined << t << ' ';
+        }
+        lines.push_back(joined.str());
+    }
+    std::sort(lines.begin(), lines.end());
+    std::ostringstream out;
+    for (const auto& l : lines) {
+        out << l << '\n';
+    }
+    return out.str();
+}
+
+std::string readFileBytes(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(GenerateGraphTest, ParallelIngestion_Test1) {
+    // 快照包含出入边表、分量和别名表，并行建图后保存的快照应与串行逐字节相同
+    const std::string serialPath = "test_ingest_serial.bin", parallelPath = "test_ingest_parallel.bin";
+    for (const std::string file : {"input.txt", "Cursed Be The Treasure.txt"}) {
+        Graph serial;
+        serial.generateGraph(file);
+        ASSERT_TRUE(serial.saveSnapshot(serialPath));
+        for (unsigned threads : {2u, 3u, 8u}) {
+            Graph parallel;
+            parallel.generateGraph(file, threads);
+            EXPECT_EQ(sortedGraphDump(serial), sortedGraphDump(parallel)) << file << " threads " << threads;
+            ASSERT_TRUE(parallel.saveSnapshot(parallelPath));
+            EXPECT_EQ(readFileBytes(serialPath), readFileBytes(parallelPath)) << file << " threads " << threads;
+        }
+    }
+    std::remove(serialPath.c_str());
+    std::remove(parallelPath.c_str());
+}
+
+TEST_F(GraphTest, Snapshot_Test1) {
+    graph.calculatePageRank(0.85);
+    const std::string snapshotPath = "test_snapshot.bin";
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+    EXPECT_TRUE(Graph::isSnapshotFile(snapshotPath));
+    EXPECT_FALSE(Graph::isSnapshotFile("input.txt"));
+
+    Graph loaded;
+    ASSERT_TRUE(loaded.loadSnapshot(snapshotPath));
+    EXPECT_EQ(sortedGraphDump(graph), sortedGraphDump(loaded));
+    EXPECT_EQ(graph.queryBridgeWords("the", "requested"), loaded.queryBridgeWords("the", "requested"));
+    EXPECT_EQ(graph.calcShortestPath("scientist", "again"), loaded.calcShortestPath("scientist", "again"));
+    for (size_t id = 0; id < graph.wordCount(); ++id) {
+        std::string word(graph.wordAt(id));
+        EXPECT_EQ(graph.calcPageRank(word), loaded.calcPageRank(word));
+    }
+
+    // 在快照之上继续追加文本，结果应与直接两次建图一致
+    loaded.generateGraph("input.txt");
+    graph.generateGraph("input.txt");
+    EXPECT_EQ(sortedGraphDump(graph), sortedGraphDump(loaded));
+    std::remove(snapshotPath.c_str());
+}
+
+TEST(SnapshotTest, Snapshot_Test3) {
+    // 快照保存阻尼系数，加载后追加文本走与内存中的图相同的增量刷新，得分逐位相同；
+    // 若加载后退回全量重算，得分只会在 tolerance 内接近
+    const std::string snapshotPath = "test_snapshot_append.bin";
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    graph.calculatePageRank(0.85);
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+
+    Graph loaded;
+    ASSERT_TRUE(loaded.loadSnapshot(snapshotPath));
+    for (const std::string text : {"treasure the be cursed", "the tide brings brand new words"}) {
+        graph.appendText(text);
+        loaded.appendText(text);
+        EXPECT_EQ(sortedGraphDump(graph), sortedGraphDump(loaded)) << text;
+        for (size_t id = 0; id < graph.wordCount(); ++id) {
+            std::string word(graph.wordAt(id));
+            EXPECT_EQ(graph.calcPageRank(word), loaded.calcPageRank(word)) << text << " " << word;
+        }
+        EXPECT_EQ(graph.topPageRank(10), loaded.topPageRank(10)) << text;
+    }
+    std::remove(snapshotPath.c_str());
+}
+
+TEST(SnapshotTest, Snapshot_Test2) {
+    const std::string snapshotPath = "test_snapshot_corrupt.bin";
+    Graph graph;
+    graph.generateGraph("input.txt");
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+
+    std::fstream file(snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-3, std::ios::end);
+    file.put('\x7f');
+    file.close();
+
+    Graph loaded;
+    EXPECT_FALSE(loaded.loadSnapshot(snapshotPath));
+    EXPECT_EQ(0u, loaded.wordCount());
+    std::remove(snapshotPath.c_str());
+}
+
+// 把快照中某个段的第一个元素改写为 value（头部 48 字节，其中第 32 字节起为段数；
+// 段表每项 24 字节：编号、元素大小、偏移、元素个数）
+void tamperSnapshotSection(const std::string& snapshotPath, uint32_t sectionId, uint32_t value) {
+    std::fstream file(snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+    uint64_t sectionCount = 0;
+    file.seekg(32);
+    file.read(reinterpret_cast<char*>(&sectionCount), sizeof(sectionCount));
+    uint64_t sectionOffset = 0;
+    for (uint64_t i = 0; i < sectionCount; ++i) {
+        uint32_t id = 0;
+        uint64_t offset = 0;
+        file.seekg(48 + 24 * i);
+        file.read(reinterpret_cast<char*>(&id), sizeof(id));
+        file.seekg(48 + 24 * i + 8);
+        file.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+        if (id == sectionId) {
+            sectionOffset = offset;
+        }
+    }
+    ASSERT_NE(0u, sectionOffset);
+    file.seekp(sectionOffset);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+TEST(SnapshotTest, Snapshot_Test4) {
+    // 把一条出边的目标改成越界的编号：加载须在校验和之前就以数据不一致拒绝，而不是留到查询时越界访问
+    const std::string snapshotPath = "test_snapshot_tampered.bin";
+    Graph graph;
+    graph.generateGraph("input.txt");
+    auto loadError = [&](bool verify) {
+        std::ostringstream captured;
+        std::streambuf* original = std::cerr.rdbuf(captured.rdbuf());
+        Graph loaded;
+        bool ok = loaded.loadSnapshot(snapshotPath, verify);
+        std::cerr.rdbuf(original);
+        EXPECT_FALSE(ok);
+        EXPECT_EQ(0u, loaded.wordCount());
+        return captured.str();
+    };
+
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+    tamperSnapshotSection(snapshotPath, 4, static_cast<uint32_t>(graph.wordCount()));  // 出边目标
+    EXPECT_NE(std::string::npos, loadError(false).find("数据不一致"));
+
+    // 入边权重与出边对不上但编号都有效：默认只有校验和能发现，verify 时在校验和之前以数据不一致拒绝
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+    tamperSnapshotSection(snapshotPath, 8, 1000000);  // 入边权重
+    EXPECT_NE(std::string::npos, loadError(false).find("校验失败"));
+    EXPECT_NE(std::string::npos, loadError(true).find("数据不一致"));
+    std::remove(snapshotPath.c_str());
+}
+
+// 按原实现的定义直接计算 PageRank，作为新实现的对照
+std::map<std::string, double> referencePageRank(const Graph& graph, double d) {
+    std::map<std::string, std::vector<std::string>> successors;
+    std::istringstream in(sortedGraphDump(graph));
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string word, edge;
+        fields >> word;
+        word.pop_back();
+        auto& targets = successors[word];
+        while (fields >> edge) {
+            targets.push_back(edge.substr(0, edge.find('(')));
+        }
+    }
+
+    std::map<std::string, double> ranks;
+    for (const auto& [word, targets] : successors) {
+        ranks[word] = 1.0;
+    }
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        std::map<std::string, double> next;
+        for (const auto& [word, targets] : successors) {
+            next[word] += (1 - d) / successors.size();
+            for (const auto& target : targets) {
+                next[target] += d * ranks[word] / targets.size();
+            }
+        }
+        bool converged = true;
+        for (const auto& [word, rank] : next) {
+            if (std::abs(rank - ranks[word]) > 1e-6) {
+                converged = false;
+            }
+        }
+        ranks = next;
+        if (converged) {
+            break;
+        }
+    }
+    return ranks;
+}
+
+TEST(PageRankTest, CalculatePageRank_Test1) {
+    for (const std::string file : {"input.txt", "Cursed Be The Treasure.txt"}) {
+        Graph graph;
+        graph.generateGraph(file);
+        graph.calculatePageRank(0.85);
+        for (const auto& [word, rank] : referencePageRank(graph, 0.85)) {
+            EXPECT_NEAR(rank, graph.calcPageRank(word), 1e-12) << file << " " << word;
+        }
+    }
+}
+
+TEST(PageRankTest, CalculatePageRank_Test2) {
+    Graph serial;
+    serial.generateGraph("Cursed Be The Treasure.txt");
+    serial.calculatePageRank(0.85, 1);
+    for (unsigned threads : {2u, 3u, 8u}) {
+        Graph parallel;
+        parallel.generateGraph("Cursed Be The Treasure.txt");
+        parallel.calculatePageRank(0.85, threads);
+        for (size_t id = 0; id < serial.wordCount(); ++id) {
+            std::string word(serial.wordAt(id));
+            ASSERT_EQ(serial.calcPageRank(word), parallel.calcPageRank(word)) << word << " threads " << threads;
+        }
+    }
+}
+
+TEST(PageRankTest, PersonalizedPageRank_Test1) {
+    // 以全部单词为种子时，个性化 PageRank 的不动点与全局 PageRank 相同
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    graph.calculatePageRank(0.85);
+    std::vector<std::string> allWords;
+    for (size_t id = 0; id < graph.wordCount(); ++id) {
+        allWords.emplace_back(graph.wordAt(id));
+    }
+    auto ranked = graph.personalizedPageRank(allWords, allWords.size(), 0.85, 1e-10);
+    ASSERT_FALSE(ranked.empty());
+    for (size_t i = 1; i < ranked.size(); ++i) {
+        EXPECT_GE(ranked[i - 1].second, ranked[i].second);
+    }
+    for (const auto& [word, score] : ranked) {
+        EXPECT_NEAR(graph.calcPageRank(word), score, 1e-4) << word;
+    }
+}
+
+TEST_F(GraphTest, PersonalizedPageRank_Test2) {
+    // "again" 没有出边，全部得分只能留在种子本身
+    auto ranked = graph.personalizedPageRank({"again"}, 10);
+    ASSERT_EQ(1u, ranked.size());
+    EXPECT_EQ("again", ranked[0].first);
+    EXPECT_NEAR(0.15, ranked[0].second, 1e-12);
+
+    ranked = graph.personalizedPageRank({"it", "nonono"}, 1);
+    ASSERT_EQ(1u, ranked.size());
+    EXPECT_EQ("it", ranked[0].first);
+    EXPECT_TRUE(graph.personalizedPageRank({"nonono"}, 5).empty());
+}
+
+TEST(PageRankTest, PersonalizedPageRank_Test3) {
+    // 默认阈值下推送是局部的：稀疏区域的种子只触及一小部分单词，阈值极小时才扩散到几乎全图
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    auto local = graph.personalizedPageRank({"cursed"}, graph.wordCount());
+    ASSERT_FALSE(local.empty());
+    EXPECT_LT(local.size(), graph.wordCount() / 20);
+    auto precise = graph.personalizedPageRank({"cursed"}, graph.wordCount(), 0.85, 1e-9);
+    EXPECT_GT(precise.size(), graph.wordCount() / 2);
+    EXPECT_EQ(precise[0].first, local[0].first);
+}
+
+TEST(PageRankTest, PersonalizedPageRank_Test4) {
+    // 出度超过 1 / epsilon 的种子也要推送：得分留在种子上，阈值更小时才分给后继
+    std::string text;
+    for (int i = 0; i < 20000; ++i) {
+        text += "hub w" + std::to_string(i) + "\n";
+    }
+    Graph graph;
+    graph.appendText(text);
+    auto ranked = graph.personalizedPageRank({"hub"}, 5);
+    ASSERT_EQ(1u, ranked.size());
+    EXPECT_EQ("hub", ranked[0].first);
+    EXPECT_NEAR(0.15, ranked[0].second, 1e-12);
+
+    ranked = graph.personalizedPageRank({"hub"}, graph.wordCount(), 0.85, 1e-6);
+    ASSERT_EQ(graph.wordCount(), ranked.size());
+    EXPECT_EQ("hub", ranked[0].first);
+    EXPECT_NEAR(0.15 * 0.85 / 20000, ranked.back().second, 1e-12);
+}
+
+TEST(PageRankTest, AppendText_Test1) {
+    const std::string appended = "The scientist carefully analyzed the data, wrote a detailed report.\n"
+                                 "Brand new words arrive with the tide and the treasure.";
+    Graph incremental;
+    incremental.generateGraph("Cursed Be The Treasure.txt");
+    incremental.calculatePageRank(0.85);
+    incremental.appendText(appended);
+
+    const std::string appendedPath = "test_append.txt";
+    {
+        std::ofstream out(appendedPath);
+        out << appended;
+    }
+    Graph full;
+    full.generateGraph("Cursed Be The Treasure.txt");
+    full.generateGraph(appendedPath);
+    full.calculatePageRank(0.85);
+    std::remove(appendedPath.c_str());
+
+    EXPECT_EQ(sortedGraphDump(full), sortedGraphDump(incremental));
+    for (size_t id = 0; id < full.wordCount(); ++id) {
+        std::string word(full.wordAt(id));
+        EXPECT_NEAR(full.calcPageRank(word), incremental.calcPageRank(word), 1e-5) << word;
+    }
+    EXPECT_GT(incremental.calcPageRank("tide"), 0.0);
+}
+
+TEST(PageRankTest, AppendText_Test2) {
+    // 没有新单词的追加走增量路径：先只累加已有边的权重，再加入反向的新边（可能合并分量），
+    // 结果须与全量重建一致，包括排名索引、分量和按权游走使用的别名表
+    const std::vector<std::string> appended = {"cursed be the treasure",
+                                               "treasure the be cursed and the cursed treasure"};
+    Graph incremental;
+    incremental.generateGraph("Cursed Be The Treasure.txt");
+    incremental.calculatePageRank(0.85);
+    std::string text;
+    for (const std::string& line : appended) {
+        incremental.appendText(line);
+        text += line + "\n";
+    }
+
+    const std::string appendedPath = "test_append.txt";
+    {
+        std::ofstream out(appendedPath);
+        out << text;
+    }
+    Graph full;
+    full.generateGraph("Cursed Be The Treasure.txt");
+    full.generateGraph(appendedPath);
+    full.calculatePageRank(0.85);
+    std::remove(appendedPath.c_str());
+
+    ASSERT_EQ(full.wordCount(), incremental.wordCount());
+    EXPECT_EQ(sortedGraphDump(full), sortedGraphDump(incremental));
+    EXPECT_EQ(full.componentCount(), incremental.componentCount());
+    EXPECT_EQ(full.canReach("treasure", "cursed"), incremental.canReach("treasure", "cursed"));
+    // 得分只在 tolerance 内一致，排名索引则须与增量结果自身的得分完全一致
+    std::vector<std::pair<double, std::string>> expected;
+    for (size_t id = 0; id < full.wordCount(); ++id) {
+        std::string word(full.wordAt(id));
+        EXPECT_NEAR(full.calcPageRank(word), incremental.calcPageRank(word), 1e-5) << word;
+        expected.emplace_back(-incremental.calcPageRank(word), word);
+    }
+    std::sort(expected.begin(), expected.end());
+    auto top = incremental.topPageRank(50);
+    for (size_t i = 0; i < top.size(); ++i) {
+        EXPECT_EQ(expected[i].second, top[i].first);
+    }
+    for (const char* word : {"cursed", "treasure", "the"}) {
+        size_t lower = std::count_if(expected.begin(), expected.end(), [&](const auto& entry) {
+            return -entry.first < incremental.calcPageRank(word);
+        });
+        EXPECT_DOUBLE_EQ(100.0 * lower / expected.size(), incremental.pageRankPercentile(word)) << word;
+    }
+
+    auto collect = [](const Graph& graph) {
+        std::vector<std::vector<Graph::WordId>> walks(2000);
+        graph.generateWalks(walks.size(), 12, 7, [&](size_t index, std::span<const Graph::WordId> walk) {
+            walks[index].assign(walk.begin(), walk.end());
+        }, 1, Graph::WalkMode::Weighted);
+        return walks;
+    };
+    EXPECT_EQ(collect(full), collect(incremental));
+}
+
+TEST(PageRankTest, TopPageRank_Test1) {
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    auto unranked = graph.topPageRank(3);
+    ASSERT_EQ(3u, unranked.size());
+    EXPECT_EQ(1.0, unranked[0].second);
+
+    graph.calculatePageRank(0.85);
+    std::vector<std::pair<double, std::string>> expected;
+    for (size_t id = 0; id < graph.wordCount(); ++id) {
+        std::string word(graph.wordAt(id));
+        expected.emplace_back(-graph.calcPageRank(word), word);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    auto top = graph.topPageRank(100);
+    ASSERT_EQ(100u, top.size());
+    for (size_t i = 0; i < top.size(); ++i) {
+        EXPECT_EQ(expected[i].second, top[i].first);
+        EXPECT_EQ(-expected[i].first, top[i].second);
+    }
+    EXPECT_EQ(graph.wordCount(), graph.topPageRank(graph.wordCount() + 10).size());
+
+    EXPECT_NEAR(100.0 * (graph.wordCount() - 1) / graph.wordCount(), graph.pageRankPercentile(top[0].first), 1e-9);
+    EXPECT_EQ(0.0, graph.pageRankPercentile(expected.back().second));
+    EXPECT_EQ(-1.0, graph.pageRankPercentile("nonono"));
+
+    const std::string snapshotPath = "test_rank_snapshot.bin";
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+    Graph loaded;
+    ASSERT_TRUE(loaded.loadSnapshot(snapshotPath));
+    EXPECT_EQ(top, loaded.topPageRank(100));
+    EXPECT_EQ(graph.pageRankPercentile("the"), loaded.pageRankPercentile("the"));
+    std::remove(snapshotPath.c_str());
+}
+
+TEST(SortedIntersectTest, IntersectSorted_Test1) {
+    std::mt19937 gen(42);
+    for (size_t na : {0u, 1u, 3u, 4u, 7u, 50u, 400u}) {
+        for (size_t nb : {0u, 2u, 5u, 64u, 1000u, 20000u}) {
+            for (uint32_t range : {16u, 256u, 100000u}) {
+                std::uniform_int_distribution<uint32_t> dis(0, range);
+                std::set<uint32_t> setA, setB;
+                while (setA.size() < std::min<size_t>(na, range / 2)) setA.insert(dis(gen));
+                while (setB.size() < std::min<size_t>(nb, range / 2)) setB.insert(dis(gen));
+                std::vector<uint32_t> a(setA.begin(), setA.end()), b(setB.begin(), setB.end());
+                std::vector<uint32_t> expected;
+                std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+                std::vector<uint32_t> actual(std::min(a.size(), b.size()));
+                actual.resize(intersectSorted(a.data(), a.size(), b.data(), b.size(), actual.data()));
+                EXPECT_EQ(expected, actual) << na << " " << nb << " " << range;
+            }
+        }
+    }
+}
+
+TEST(BridgeWordsTest, QueryBridgeWordsBatch_Test1) {
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    std::vector<std::string> words;
+    for (size_t id = 0; id < graph.wordCount(); id += 7) {
+        words.emplace_back(graph.wordAt(id));
+    }
+    words.insert(words.end(), {"the", "a", "of", "and", "nonono", ""});
+
+    std::vector<Graph::WordPair> pairs;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<size_t> dis(0, words.size() - 1);
+    for (int i = 0; i < 5000; ++i) {
+        pairs.emplace_back(words[dis(gen)], words[dis(gen)]);
+    }
+    pairs.emplace_back("the", "the");
+    pairs.emplace_back("of", "the");
+
+    Graph::BridgeBatch batch;
+    graph.queryBridgeWordsBatch(pairs, batch);
+    ASSERT_EQ(pairs.size() + 1, batch.offsets.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        std::vector<std::string> actual;
+        for (uint64_t k = batch.offsets[i]; k < batch.offsets[i + 1]; ++k) {
+            actual.emplace_back(graph.wordAt(batch.bridges[k]));
+        }
+        EXPECT_EQ(graph.queryBridgeWords(std::string(pairs[i].first), std::string(pairs[i].second)), actual);
+    }
+
+    // 两个线程各处理一半，结果与整体处理一致
+    std::span<const Graph::WordPair> all(pairs);
+    Graph::BridgeBatch first, second;
+    std::thread worker([&] { graph.queryBridgeWordsBatch(all.first(pairs.size() / 2), first); });
+    graph.queryBridgeWordsBatch(all.subspan(pairs.size() / 2), second);
+    worker.join();
+    std::vector<Graph::WordId> combined = first.bridges;
+    combined.insert(combined.end(), second.bridges.begin(), second.bridges.end());
+    EXPECT_EQ(batch.bridges, combined);
+}
+
+TEST(GenerateNewTextTest, StreamingRewrite_Test1) {
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    std::ifstream inFile("Cursed Be The Treasure.txt", std::ios::binary);
+    std::stringstream buffer;
+    buffer << inFile.rdbuf();
+    std::string text = buffer.str() + "Seek to explore new and exciting synergies\nno trailing newline";
+
+    // 每行结果与单独调用 generateNewText 相同，行结构保持不变
+    std::string expected;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        expected += graph.generateNewText(line);
+        if (!lines.eof()) {
+            expected += '\n';
+        }
+    }
+
+    for (unsigned threads : {1u, 3u}) {
+        std::istringstream input(text);
+        std::ostringstream output;
+        graph.generateNewText(input, output, threads);
+        EXPECT_EQ(expected, output.str()) << threads;
+    }
+
+    std::ofstream("stream_input.txt", std::ios::binary) << text;
+    ASSERT_TRUE(graph.generateNewTextFile("stream_input.txt", "stream_output.txt", 2));
+    std::ifstream outFile("stream_output.txt", std::ios::binary);
+    std::stringstream written;
+    written << outFile.rdbuf();
+    EXPECT_EQ(expected, written.str());
+    std::remove("stream_input.txt");
+    std::remove("stream_output.txt");
+}
+
+TEST(ShortestPathTest, RadixHeap_Test1) {
+    // 单调使用：每次弹出后只压入不小于已弹出键的元素，弹出序列应与排序结果一致
+    std::mt19937 gen(11);
+    RadixHeap heap;
+    std::vector<uint64_t> popped, pushed;
+    uint64_t last = 0;
+    for (int round = 0; round < 2000; ++round) {
+        for (int k = gen() % 4; k > 0; --k) {
+            uint64_t key = last + (round % 7 == 0 ? gen() % 1000000 : gen() % 5);
+            heap.push(key, static_cast<uint32_t>(round));
+            pushed.push_back(key);
+        }
+        if (!heap.empty()) {
+            last = heap.pop().first;
+            popped.push_back(last);
+        }
+    }
+    while (!heap.empty()) {
+        popped.push_back(heap.pop().first);
+    }
+    EXPECT_TRUE(std::is_sorted(popped.begin(), popped.end()));
+    std::sort(pushed.begin(), pushed.end());
+    EXPECT_EQ(pushed, popped);
+}
+
+TEST(ShortestPathTest, CalcShortestPath_Test3) {
+    // a -> b -> d 与 a -> c -> d 等长，取编号较小的前驱；x -> e 出现两次，权重为 2
+    Graph graph;
+    graph.appendText("a b d a c d x e a x x x e");
+    EXPECT_EQ("a -> b -> d", graph.calcShortestPath("a", "d"));
+    EXPECT_EQ("a -> x -> e", graph.calcShortestPath("a", "e"));
+    EXPECT_EQ("c -> d -> a -> b", graph.calcShortestPath("c", "b"));
+
+    // 同一线程上交替查询两张图，工作区复用不影响结果
+    Graph other;
+    other.generateGraph("input.txt");
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ("the -> team -> requested", other.calcShortestPath("the", "requested"));
+        EXPECT_EQ("a -> b -> d", graph.calcShortestPath("a", "d"));
+        EXPECT_EQ("No path found", other.calcShortestPath("again", "the"));
+    }
+}
+
+// 原 calcShortestPath 的做法：以 (距离, 单词) 为键的优先队列，单词的字典序即编号顺序
+std::string referenceShortestPath(const std::map<std::string, std::map<std::string, int>>& edges,
+                                  const std::string& source, const std::string& target) {
+    std::map<std::string, int64_t> distances;
+    std::map<std::string, std::string> predecessors;
+    std::priority_queue<std::pair<int64_t, std::string>, std::vector<std::pair<int64_t, std::string>>, std::greater<>> pq;
+    distances[source] = 0;
+    pq.push({0, source});
+    while (!pq.empty()) {
+        auto [dist, current] = pq.top();
+        pq.pop();
+        if (current == target) break;
+        if (dist > distances[current]) continue;
+        auto it = edges.find(current);
+        if (it == edges.end()) continue;
+        for (const auto& [next, weight] : it->second) {
+            if (!distances.count(next) || dist + weight < distances[next]) {
+                distances[next] = dist + weight;
+                predecessors[next] = current;
+                pq.push({dist + weight, next});
+            }
+        }
+    }
+    if (!distances.count(target)) {
+        return "No path found";
+    }
+    std::string path = target;
+    for (std::string at = target; at != source; ) {
+        at = predecessors[at];
+        path = at + " -> " + path;
+    }
+    return path;
+}
+
+TEST(ShortestPathTest, CalcShortestPath_Test4) {
+    // 小词表的随机文本，边权小、并列的最短路很多，逐对与原算法比较
+    std::mt19937 gen(3);
+    for (int round = 0; round < 5; ++round) {
+        std::uniform_int_distribution<int> dis(0, 10 + round * 8);
+        std::string text;
+        std::vector<std::string> tokens;
+        for (int i = 0; i < 300; ++i) {
+            tokens.push_back("w" + std::to_string(dis(gen)));
+            text += tokens.back() + " ";
+        }
+        std::map<std::string, std::map<std::string, int>> edges;
+        for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+            edges[tokens[i]][tokens[i + 1]]++;
+        }
+
+        // 不预处理（双向搜索）和两种地标选法（A*）都应与原算法逐字相同
+        Graph graph;
+        graph.appendText(text);
+        Graph farthest = graph, ranked = graph;
+        ASSERT_EQ(4u, farthest.buildLandmarks(4, Graph::LandmarkSelection::Farthest, 1));
+        ASSERT_EQ(3u, ranked.buildLandmarks(3, Graph::LandmarkSelection::PageRank, 2));
+        ASSERT_EQ(4u, farthest.landmarkCount());
+        for (size_t a = 0; a < graph.wordCount(); ++a) {
+            for (size_t b = 0; b < graph.wordCount(); ++b) {
+                std::string source(graph.wordAt(a)), target(graph.wordAt(b));
+                std::string expected = referenceShortestPath(edges, source, target);
+                EXPECT_EQ(expected, graph.calcShortestPath(source, target));
+                EXPECT_EQ(expected, farthest.calcShortestPath(source, target));
+                EXPECT_EQ(expected, ranked.calcShortestPath(source, target));
+            }
+        }
+    }
+}
+
+TEST_F(GraphTest, Landmarks_Test1) {
+    // 是否在小图上建立地标由调用方决定；返回值是实际建立的数目
+    EXPECT_EQ(3u, graph.buildLandmarks(3));
+    EXPECT_EQ(3u, graph.landmarkCount());
+    EXPECT_EQ(3u, graph.buildLandmarks(3, Graph::LandmarkSelection::Farthest, 1));
+    EXPECT_EQ(3u, graph.landmarkCount());
+    EXPECT_EQ("the -> team -> requested", graph.calcShortestPath("the", "requested"));
+    EXPECT_EQ("No path found", graph.calcShortestPath("again", "the"));
+
+    // 地标表随快照保存和加载；追加文本后失效
+    const std::string snapshotPath = "landmarks_snapshot.bin";
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+    Graph loaded;
+    ASSERT_TRUE(loaded.loadSnapshot(snapshotPath));
+    EXPECT_EQ(3u, loaded.landmarkCount());
+    for (size_t a = 0; a < graph.wordCount(); ++a) {
+        for (size_t b = 0; b < graph.wordCount(); ++b) {
+            std::string source(graph.wordAt(a)), target(graph.wordAt(b));
+            EXPECT_EQ(graph.calcShortestPath(source, target), loaded.calcShortestPath(source, target));
+        }
+    }
+    loaded.appendText("again the");
+    EXPECT_EQ(0u, loaded.landmarkCount());
+    EXPECT_EQ("again -> the", loaded.calcShortestPath("again", "the"));
+    std::remove(snapshotPath.c_str());
+}
+
+TEST_F(GraphTest, ShortestPathsFrom_Test1) {
+    Graph::ShortestPathTree tree = graph.shortestPathsFrom("the");
+    ASSERT_EQ(graph.findWord("the"), tree.source);
+    ASSERT_EQ(graph.wordCount(), tree.distances.size());
+    for (size_t id = 0; id < graph.wordCount(); ++id) {
+        std::string target(graph.wordAt(id));
+        if (tree.distances[id] == Graph::kUnreachable) {
+            EXPECT_EQ("No path found", graph.calcShortestPath("the", target));
+            EXPECT_EQ(Graph::kNoWord, tree.predecessors[id]);
+            continue;
+        }
+        // 沿前驱回溯得到的路径与 calcShortestPath 相同
+        std::string path = target;
+        for (Graph::WordId at = static_cast<Graph::WordId>(id); at != tree.source; ) {
+            at = tree.predecessors[at];
+            path = std::string(graph.wordAt(at)) + " -> " + path;
+        }
+        EXPECT_EQ(graph.calcShortestPath("the", target), path);
+    }
+    EXPECT_EQ(Graph::kNoWord, graph.shortestPathsFrom("nonono").source);
+}
+
+TEST(ShortestPathTest, ShortestPathsFromMany_Test1) {
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    std::vector<Graph::WordId> sources;
+    for (size_t id = 0; id < graph.wordCount(); id += 97) {
+        sources.push_back(static_cast<Graph::WordId>(id));
+    }
+
+    std::vector<std::vector<int64_t>> distances(sources.size());
+    std::vector<std::vector<Graph::WordId>> predecessors(sources.size());
+    graph.shortestPathsFromMany(sources, [&](size_t index, const Graph::ShortestPathTree& tree) {
+        EXPECT_EQ(sources[index], tree.source);
+        distances[index] = tree.distances;
+        predecessors[index] = tree.predecessors;
+    }, 4);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        Graph::ShortestPathTree expected = graph.shortestPathsFrom(std::string(graph.wordAt(sources[i])));
+        EXPECT_EQ(expected.distances, distances[i]);
+        EXPECT_EQ(expected.predecessors, predecessors[i]);
+    }
+
+    // sources 为空时对全部单词执行
+    Graph small;
+    small.generateGraph("input.txt");
+    std::vector<int> visited(small.wordCount(), 0);
+    small.shortestPathsFromMany({}, [&](size_t index, const Graph::ShortestPathTree& tree) {
+        visited[index]++;
+        EXPECT_EQ(0, tree.distances[tree.source]);
+    }, 3);
+    EXPECT_EQ(std::vector<int>(small.wordCount(), 1), visited);
+}
+
+// 深度优先枚举 source 到 target 的全部无环路径的权重，升序
+std::vector<int64_t> allSimplePathWeights(const std::map<std::string, std::map<std::string, int>>& edges,
+                                          const std::string& source, const std::string& target) {
+    std::vector<int64_t> weights;
+    std::set<std::string> onPath = {source};
+    std::function<void(const std::string&, int64_t)> dfs = [&](const std::string& at, int64_t weight) {
+        if (at == target) {
+            weights.push_back(weight);
+            return;
+        }
+        auto it = edges.find(at);
+        if (it == edges.end()) return;
+        for (const auto& [next, w] : it->second) {
+            if (onPath.insert(next).second) {
+                dfs(next, weight + w);
+                onPath.erase(next);
+            }
+        }
+    };
+    dfs(source, 0);
+    std::sort(weights.begin(), weights.end());
+    return weights;
+}
+
+TEST(ShortestPathTest, KShortestPaths_Test1) {
+    std::mt19937 gen(5);
+    for (int round = 0; round < 4; ++round) {
+        std::uniform_int_distribution<int> dis(0, 7);
+        std::vector<std::string> tokens;
+        std::string text;
+        for (int i = 0; i < 40; ++i) {
+            tokens.push_back("w" + std::to_string(dis(gen)));
+            text += tokens.back() + " ";
+        }
+        std::map<std::string, std::map<std::string, int>> edges;
+        for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+            edges[tokens[i]][tokens[i + 1]]++;
+        }
+        Graph graph;
+        graph.appendText(text);
+
+        for (size_t a = 0; a < graph.wordCount(); ++a) {
+            for (size_t b = 0; b < graph.wordCount(); ++b) {
+                std::string source(graph.wordAt(a)), target(graph.wordAt(b));
+                std::vector<int64_t> expected = allSimplePathWeights(edges, source, target);
+                const size_t k = 12;
+                auto paths = graph.kShortestPaths(source, target, k);
+                ASSERT_EQ(std::min(k, expected.size()), paths.size()) << source << " " << target;
+
+                std::set<std::vector<Graph::WordId>> distinct;
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    EXPECT_EQ(expected[i], paths[i].weight);
+                    // 路径无环、边都存在、总权重正确
+                    const auto& words = paths[i].words;
+                    EXPECT_EQ(words.size(), std::set<Graph::WordId>(words.begin(), words.end()).size());
+                    EXPECT_EQ(a, words.front());
+                    EXPECT_EQ(b, words.back());
+                    int64_t weight = 0;
+                    for (size_t j = 0; j + 1 < words.size(); ++j) {
+                        weight += edges[std::string(graph.wordAt(words[j]))][std::string(graph.wordAt(words[j + 1]))];
+                    }
+                    EXPECT_EQ(paths[i].weight, weight);
+                    distinct.insert(words);
+                }
+                EXPECT_EQ(paths.size(), distinct.size());
+                if (!paths.empty()) {
+                    std::string first;
+                    for (Graph::WordId id : paths[0].words) {
+                        first += (first.empty() ? "" : " -> ") + std::string(graph.wordAt(id));
+                    }
+                    EXPECT_EQ(graph.calcShortestPath(source, target), first);
+                }
+            }
+        }
+    }
+}
+
+TEST(ComponentsTest, StronglyConnected_Test1) {
+    // 随机文本：用逐对的广度优先搜索检验分量划分、可达性和分量编号的拓扑顺序
+    std::mt19937 gen(7);
+    for (int round = 0; round < 4; ++round) {
+        std::uniform_int_distribution<int> dis(0, 30);
+        std::vector<std::string> tokens;
+        std::string text;
+        for (int i = 0; i < 60; ++i) {
+            tokens.push_back("w" + std::to_string(dis(gen)));
+            text += tokens.back() + " ";
+        }
+        Graph graph;
+        graph.appendText(text);
+        const size_t n = graph.wordCount();
+        std::vector<std::vector<Graph::WordId>> next(n);
+        for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+            next[graph.findWord(tokens[i])].push_back(graph.findWord(tokens[i + 1]));
+        }
+        std::vector<std::vector<char>> reach(n, std::vector<char>(n, 0));
+        for (size_t a = 0; a < n; ++a) {
+            std::vector<size_t> pending = {a};
+            reach[a][a] = 1;
+            while (!pending.empty()) {
+                size_t v = pending.back();
+                pending.pop_back();
+                for (Graph::WordId w : next[v]) {
+                    if (!reach[a][w]) {
+                        reach[a][w] = 1;
+                        pending.push_back(w);
+                    }
+                }
+            }
+        }
+
+        size_t total = 0;
+        for (size_t c = 0; c < graph.componentCount(); ++c) {
+            total += graph.componentSize(c);
+        }
+        EXPECT_EQ(n, total);
+        for (size_t a = 0; a < n; ++a) {
+            for (size_t b = 0; b < n; ++b) {
+                std::string source(graph.wordAt(a)), target(graph.wordAt(b));
+                uint32_t ca = graph.componentOf(source), cb = graph.componentOf(target);
+                EXPECT_EQ(reach[a][b] && reach[b][a], ca == cb);
+                EXPECT_EQ(bool(reach[a][b]), graph.canReach(source, target));
+                if (reach[a][b]) {
+                    EXPECT_GE(ca, cb);
+                }
+                if (a != b) {
+                    EXPECT_EQ(!reach[a][b], graph.calcShortestPath(source, target) == "No path found");
+                }
+            }
+        }
+    }
+}
+
+TEST(ComponentsTest, StronglyConnected_Test2) {
+    // 分量数超过建立传递闭包的规模，可达性由区间标签和凝聚图上的搜索回答；
+    // 每行的单词编号大体递增，偶尔回退几步形成小的环
+    std::mt19937 gen(11);
+    const int kWords = 40000;
+    std::uniform_int_distribution<int> startDis(0, kWords - 1), stepDis(1, 40), backDis(1, 3), chance(0, 9);
+    std::vector<std::vector<int>> lines;
+    std::string text;
+    for (int line = 0; line < 4000; ++line) {
+        std::vector<int> ids = {startDis(gen)};
+        for (int i = 0; i < 20; ++i) {
+            int next = chance(gen) == 0 ? std::max(0, ids.back() - backDis(gen)) : ids.back() + stepDis(gen);
+            if (next >= kWords) break;
+            ids.push_back(next);
+        }
+        for (int id : ids) {
+            text += "n" + std::to_string(id) + " ";
+        }
+        text += "\n";
+        lines.push_back(std::move(ids));
+    }
+    Graph graph;
+    graph.appendText(text);
+    ASSERT_GT(graph.componentCount(), 30000u);
+
+    const size_t n = graph.wordCount();
+    std::vector<std::vector<Graph::WordId>> next(n);
+    for (const auto& ids : lines) {
+        for (size_t i = 0; i + 1 < ids.size(); ++i) {
+            next[graph.findWord("n" + std::to_string(ids[i]))].push_back(graph.findWord("n" + std::to_string(ids[i + 1])));
+        }
+    }
+    std::uniform_int_distribution<size_t> wordDis(0, n - 1);
+    for (int round = 0; round < 20; ++round) {
+        size_t a = wordDis(gen);
+        std::vector<char> reach(n, 0);
+        std::vector<size_t> pending = {a};
+        reach[a] = 1;
+        while (!pending.empty()) {
+            size_t v = pending.back();
+            pending.pop_back();
+            for (Graph::WordId w : next[v]) {
+                if (!reach[w]) {
+                    reach[w] = 1;
+                    pending.push_back(w);
+                }
+            }
+        }
+        std::string source(graph.wordAt(a));
+        for (size_t b = 0; b < n; ++b) {
+            ASSERT_EQ(bool(reach[b]), graph.canReach(source, std::string(graph.wordAt(b)))) << source << " " << graph.wordAt(b);
+        }
+    }
+}
+
+TEST_F(GraphTest, Components_Test1) {
+    EXPECT_EQ(Graph::kNoWord, graph.componentOf("nonono"));
+    EXPECT_FALSE(graph.canReach("the", "nonono"));
+    EXPECT_TRUE(graph.canReach("the", "requested"));
+    EXPECT_FALSE(graph.canReach("again", "the"));
+
+    // 分量随快照保存和加载，追加文本后重新计算
+    const std::string snapshotPath = "components_snapshot.bin";
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+    Graph loaded;
+    ASSERT_TRUE(loaded.loadSnapshot(snapshotPath));
+    ASSERT_EQ(graph.componentCount(), loaded.componentCount());
+    for (size_t id = 0; id < graph.wordCount(); ++id) {
+        std::string word(graph.wordAt(id));
+        EXPECT_EQ(graph.componentOf(word), loaded.componentOf(word));
+    }
+    loaded.appendText("again the");
+    EXPECT_TRUE(loaded.canReach("again", "the"));
+    EXPECT_EQ(loaded.componentOf("again"), loaded.componentOf("the"));
+    std::remove(snapshotPath.c_str());
+}
+
+TEST(RandomWalkTest, WalkMode_Test1) {
+    // a -> b 出现两次、a -> c 一次：按权重走时从 a 出发约 2/3 到 b，等概率时约 1/2
+    Graph graph;
+    graph.appendText("a b a b a c");
+    const std::string snapshotPath = "walk_snapshot.bin";
+    ASSERT_TRUE(graph.saveSnapshot(snapshotPath));
+    Graph loaded;
+    ASSERT_TRUE(loaded.loadSnapshot(snapshotPath));
+    std::remove(snapshotPath.c_str());
+
+    auto fractionToB = [](const Graph& g, Graph::WalkMode mode) {
+        size_t toB = 0, fromA = 0;
+        for (int i = 0; i < 20000; ++i) {
+            std::string walk = g.randomWalk(mode);
+            EXPECT_EQ('c', walk.back());
+            for (size_t at = walk.find("a -> "); at != std::string::npos; at = walk.find("a -> ", at + 1)) {
+                ++fromA;
+                toB += walk[at + 5] == 'b';
+            }
+        }
+        return double(toB) / fromA;
+    };
+    EXPECT_NEAR(2.0 / 3, fractionToB(graph, Graph::WalkMode::Weighted), 0.02);
+    EXPECT_NEAR(2.0 / 3, fractionToB(loaded, Graph::WalkMode::Weighted), 0.02);
+    EXPECT_NEAR(0.5, fractionToB(graph, Graph::WalkMode::Uniform), 0.02);
+    EXPECT_EQ("", Graph().randomWalk(Graph::WalkMode::Weighted));
+}
+
+TEST(RandomWalkTest, GenerateWalks_Test1) {
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    const size_t numWalks = 10000, maxLength = 20;
+    auto collect = [&](unsigned threads, uint64_t seed) {
+        std::vector<std::vector<Graph::WordId>> walks(numWalks);
+        graph.generateWalks(numWalks, maxLength, seed, [&](size_t index, std::span<const Graph::WordId> walk) {
+            walks[index].assign(walk.begin(), walk.end());
+        }, threads, Graph::WalkMode::Weighted);
+        return walks;
+    };
+
+    // 从导出的边表得到邻接关系：每一步都须沿一条真实的出边，提前结束的游走须停在没有出边的单词上
+    const std::string edgesPath = "walk_edges.tsv";
+    ASSERT_TRUE(graph.exportGraph(edgesPath, Graph::ExportFormat::Tsv));
+    std::set<std::pair<std::string, std::string>> edges;
+    std::set<std::string> hasOut;
+    {
+        std::ifstream edgesFile(edgesPath);
+        std::string header, source, target;
+        int weight;
+        std::getline(edgesFile, header);
+        while (edgesFile >> source >> target >> weight) {
+            edges.emplace(source, target);
+            hasOut.insert(source);
+        }
+    }
+    std::remove(edgesPath.c_str());
+
+    // 结果只取决于种子，与线程数无关
+    auto walks = collect(1, 42);
+    EXPECT_EQ(walks, collect(3, 42));
+    EXPECT_NE(walks, collect(1, 43));
+    for (size_t i = 0; i < numWalks; ++i) {
+        const auto& walk = walks[i];
+        ASSERT_FALSE(walk.empty());
+        EXPECT_LE(walk.size(), maxLength);
+        EXPECT_EQ(i % graph.wordCount(), walk.front());
+        for (size_t j = 0; j + 1 < walk.size(); ++j) {
+            std::string from(graph.wordAt(walk[j])), to(graph.wordAt(walk[j + 1]));
+            EXPECT_TRUE(edges.count({from, to})) << from << " -> " << to;
+        }
+        if (walk.size() < maxLength) {
+            EXPECT_FALSE(hasOut.count(std::string(graph.wordAt(walk.back()))));
+        }
+    }
+
+    // 文件输出与回调逐条相同
+    const std::string walksPath = "walks.txt";
+    ASSERT_TRUE(graph.generateWalksFile(walksPath, numWalks, maxLength, 42, 2, Graph::WalkMode::Weighted));
+    std::ifstream walksFile(walksPath);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(walksFile, line)) {
+        std::istringstream ids(line);
+        std::vector<Graph::WordId> walk;
+        for (Graph::WordId id; ids >> id; ) {
+            walk.push_back(id);
+        }
+        ASSERT_LT(lines, numWalks);
+        EXPECT_EQ(walks[lines], walk);
+        ++lines;
+    }
+    EXPECT_EQ(numWalks, lines);
+    walksFile.close();
+    std::remove(walksPath.c_str());
+}
+
+// 按 " -> " 和 " | " 拆开游走输出，返回单词序列，restarts 记录由重启到达的位置
+std::vector<std::string> splitWalk(const std::string& walk, std::vector<size_t>* restarts = nullptr) {
+    std::vector<std::string> words;
+    size_t begin = 0;
+    while (true) {
+        size_t arrow = walk.find(" -> ", begin), bar = walk.find(" | ", begin);
+        size_t end = std::min(arrow, bar);
+        words.push_back(walk.substr(begin, end - begin));
+        if (end == std::string::npos) break;
+        if (end == bar && restarts != nullptr) restarts->push_back(words.size());
+        begin = end + (end == arrow ? 4 : 3);
+    }
+    return words;
+}
+
+TEST(RandomWalkTest, WalkPolicy_Test1) {
+    // 只有 a -> b、b -> a 两条边：重复边策略下必然走满两条边后在第三步停止
+    Graph cycle;
+    cycle.appendText("a b a b");
+    Graph::WalkPolicy repeat;
+    repeat.stopOnRepeatedEdge = true;
+    repeat.restartProbability = 0.9;  // 没有长度限制时不生效
+    for (int i = 0; i < 20; ++i) {
+        std::string walk = cycle.randomWalk(repeat);
+        EXPECT_TRUE(walk == "a -> b -> a -> b" || walk == "b -> a -> b -> a") << walk;
+    }
+
+    // 带重启：长度恰为上限，重启后回到起点
+    Graph::WalkPolicy restart;
+    restart.maxLength = 200;
+    restart.restartProbability = 0.3;
+    std::vector<size_t> restarts;
+    std::vector<std::string> words = splitWalk(cycle.randomWalk(restart), &restarts);
+    EXPECT_EQ(200u, words.size());
+    EXPECT_FALSE(restarts.empty());
+    for (size_t at : restarts) {
+        EXPECT_EQ(words[0], words[at]);
+    }
+
+    // 有环的大图上按长度或重复边停止，重复的只有最后一条边
+    Graph graph;
+    graph.generateGraph("Cursed Be The Treasure.txt");
+    Graph::WalkPolicy bounded;
+    bounded.mode = Graph::WalkMode::Weighted;
+    bounded.maxLength = 50;
+    EXPECT_GE(50u, splitWalk(graph.randomWalk(bounded)).size());
+    for (int i = 0; i < 20; ++i) {
+        words = splitWalk(graph.randomWalk(repeat));
+        std::set<std::pair<std::string, std::string>> edges;
+        for (size_t j = 0; j + 1 < words.size(); ++j) {
+            bool inserted = edges.emplace(words[j], words[j + 1]).second;
+            EXPECT_TRUE(inserted || j + 2 == words.size());
+        }
+    }
+}
+
+TEST(ExportTest, ExportGraph_Test1) {
+    // node、edge 是 DOT 关键字，2nd 以数字开头，不加引号时 dot 无法解析
+    Graph graph;
+    graph.appendText("the node 2nd edge the node");
+    const std::string path = "export_test.out";
+
+    ASSERT_TRUE(graph.exportGraph(path, Graph::ExportFormat::Dot));
+    std::string dot = readFileBytes(path);
+    EXPECT_NE(std::string::npos, dot.find("    \"2nd\";\n"));
+    EXPECT_NE(std::string::npos, dot.find("    \"the\" -> \"node\" [label=\"2\"];\n"));
+    EXPECT_EQ("}\n", dot.substr(dot.size() - 2));
+
+    ASSERT_TRUE(graph.exportGraph(path, Graph::ExportFormat::Tsv));
+    EXPECT_EQ("source\ttarget\tweight\n"
+              "2nd\tedge\t1\n"
+              "edge\tthe\t1\n"
+              "node\t2nd\t1\n"
+              "the\tnode\t2\n", readFileBytes(path));
+
+    ASSERT_TRUE(graph.exportGraph(path, Graph::ExportFormat::GraphML));
+    std::string graphml = readFileBytes(path);
+    EXPECT_NE(std::string::npos, graphml.find("<node id=\"n0\"><data key=\"word\">2nd</data></node>"));
+    EXPECT_NE(std::string::npos, graphml.find("<edge source=\"n3\" target=\"n2\"><data key=\"weight\">2</data></edge>"));
+
+    // 二进制：28 字节头部、单词表、每条边 12 字节
+    ASSERT_TRUE(graph.exportGraph(path, Graph::ExportFormat::BinaryEdges));
+    std::string binary = readFileBytes(path);
+    ASSERT_EQ(0u, binary.find("WGEL"));
+    uint64_t counts[3];
+    std::memcpy(counts, binary.data() + 8, sizeof(counts));
+    EXPECT_EQ(4u, counts[0]);
+    EXPECT_EQ(4u, counts[1]);
+    EXPECT_EQ("2nd\nedge\nnode\nthe\n", binary.substr(32, counts[2]));
+    ASSERT_EQ(32 + counts[2] + 4 * 12, binary.size());
+    int32_t last[3];
+    std::memcpy(last, binary.data() + binary.size() - 12, sizeof(last));
+    EXPECT_EQ(3, last[0]);
+    EXPECT_EQ(2, last[1]);
+    EXPECT_EQ(2, last[2]);
+
+    // 多线程导出与单线程逐字节相同
+    Graph large;
+    large.generateGraph("Cursed Be The Treasure.txt");
+    for (Graph::ExportFormat format : {Graph::ExportFormat::Dot, Graph::ExportFormat::Tsv,
+                                       Graph::ExportFormat::GraphML, Graph::ExportFormat::BinaryEdges}) {
+        ASSERT_TRUE(large.exportGraph(path, format, 1));
+        std::string serial = readFileBytes(path);
+        ASSERT_TRUE(large.exportGraph(path, format, 3));
+        EXPECT_EQ(serial, readFileBytes(path));
+    }
+    std::remove(path.c_str());
+    EXPECT_FALSE(graph.exportGraph("no_such_dir/export.dot", Graph::ExportFormat::Dot));
+}
+
+TEST_F(GraphTest, ExportSubgraph_Test1) {
+    const std::string path = "subgraph_test.out";
+    // 不设条件时与全图导出相同
+    for (Graph::ExportFormat format : {Graph::ExportFormat::Dot, Graph::ExportFormat::BinaryEdges}) {
+        ASSERT_TRUE(graph.exportGraph(path, format));
+        std::string full = readFileBytes(path);
+        ASSERT_TRUE(graph.exportSubgraph(path, format, Graph::SubgraphFilter{}));
+        EXPECT_EQ(full, readFileBytes(path));
+    }
+
+    // 权重阈值，并去掉孤立的单词
+    Graph::SubgraphFilter heavy;
+    heavy.minWeight = 2;
+    heavy.dropIsolated = true;
+    ASSERT_TRUE(graph.exportSubgraph(path, Graph::ExportFormat::Tsv, heavy));
+    EXPECT_EQ("source\ttarget\tweight\nthe\tscientist\t2\nthe\tteam\t2\n", readFileBytes(path));
+    ASSERT_TRUE(graph.exportSubgraph(path, Graph::ExportFormat::BinaryEdges, heavy));
+    std::string binary = readFileBytes(path);
+    uint64_t counts[3];
+    std::memcpy(counts, binary.data() + 8, sizeof(counts));
+    EXPECT_EQ(3u, counts[0]);
+    EXPECT_EQ(2u, counts[1]);
+    EXPECT_EQ("scientist\nteam\nthe\n", binary.substr(32, counts[2]));
+    int32_t first[3];
+    std::memcpy(first, binary.data() + 32 + counts[2], sizeof(first));
+    EXPECT_EQ(2, first[0]);
+    EXPECT_EQ(0, first[1]);
+
+    // 一跳邻域：the 及其全部前驱和后继
+    Graph::SubgraphFilter around;
+    around.seeds = {"the"};
+    ASSERT_TRUE(graph.exportSubgraph(path, Graph::ExportFormat::Dot, around));
+    std::string dot = readFileBytes(path);
+    for (const char* word : {"the", "analyzed", "but", "shared", "so", "with", "data", "report", "scientist", "team"}) {
+        EXPECT_NE(std::string::npos, dot.find("    \"" + std::string(word) + "\";\n")) << word;
+    }
+    EXPECT_EQ(std::string::npos, dot.find("\"again\""));
+
+    // PageRank 前 3 名：只含这三个单词之间的边；尚未计算 PageRank 时拒绝导出
+    Graph::SubgraphFilter top;
+    top.topN = 3;
+    std::ostringstream captured;
+    std::streambuf* original = std::cerr.rdbuf(captured.rdbuf());
+    EXPECT_FALSE(graph.exportSubgraph(path, Graph::ExportFormat::Tsv, top));
+    std::cerr.rdbuf(original);
+    graph.calculatePageRank();
+    ASSERT_TRUE(graph.exportSubgraph(path, Graph::ExportFormat::Tsv, top));
+    std::set<std::string> topWords;
+    for (const auto& [word, rank] : graph.topPageRank(3)) {
+        topWords.insert(word);
+    }
+    std::istringstream tsv(readFileBytes(path));
+    std::string source, target, weight;
+    tsv >> source >> target >> weight;
+    while (tsv >> source >> target >> weight) {
+        EXPECT_TRUE(topWords.count(source) && topWords.count(target)) << source << " " << target;
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(GraphTest, ShowDirectedGraphOptions_Test1) {
+    auto dump = [&](const Graph::GraphDumpOptions& options, const std::string& input = "") {
+        std::ostringstream output;
+        std::istringstream pager(input);
+        graph.showDirectedGraph(options, output, pager);
+        std::vector<std::string> lines;
+        std::istringstream in(output.str());
+        for (std::string line; std::getline(in, line); ) {
+            lines.push_back(line);
+        }
+        return lines;
+    };
+
+    // 出度最大的是 the（data、report、scientist、team）
+    Graph::GraphDumpOptions byDegree;
+    byDegree.order = Graph::GraphOrder::OutDegree;
+    byDegree.limit = 1;
+    EXPECT_EQ(std::vector<std::string>{"the: data(1) report(1) scientist(2) team(2) "}, dump(byDegree));
+
+    graph.calculatePageRank();
+    Graph::GraphDumpOptions byRank;
+    byRank.order = Graph::GraphOrder::PageRank;
+    byRank.limit = 4;
+    std::vector<std::string> lines = dump(byRank);
+    auto top = graph.topPageRank(4);
+    ASSERT_EQ(4u, lines.size());
+    for (size_t i = 0; i < top.size(); ++i) {
+        EXPECT_EQ(top[i].first + ":", lines[i].substr(0, lines[i].find(' ')));
+    }
+
+    // 分页：第一页后回车继续，第二页后输入 q 结束
+    Graph::GraphDumpOptions paged;
+    paged.pageSize = 5;
+    lines = dump(paged, "\nq\n");
+    ASSERT_EQ(12u, lines.size());
+    EXPECT_EQ(0u, lines[5].find("-- 第 1 页"));
+    EXPECT_EQ(0u, lines[11].find("-- 第 2 页"));
+    EXPECT_EQ(0u, lines[0].find("a: "));
+    EXPECT_EQ(graph.wordCount(), dump(Graph::GraphDumpOptions{}).size());
+}
+
 int RunAllTests(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();